@@ -0,0 +1,98 @@
+module;
+
+export module benchmark.Accessors;
+
+import benchmark.Tools;
+import entities.Action;
+import entities.Game; // CashGame
+import entities.Hand;
+import entities.HandId;
+import entities.Player;
+import entities.Site;
+import history.WinamaxGameHistory;
+import system.StringPool;
+
+#pragma warning( push )
+#pragma warning( disable : 4686)
+import std;
+#pragma warning( pop )
+
+export namespace benchmark {
+/**
+ * Reads all the data of the site parsed from HISTORY_FILE nbPasses times, through copies as the
+ * former getters returned, then through the views the getters return, and prints the number of
+ * allocations of each way.
+ */
+void runAccessorBenchmark(std::size_t nbPasses);
+} // namespace benchmark
+
+module : private;
+
+// how the getters used to be read: each string copied, the hands copied in a vector
+[[nodiscard]] static std::size_t readWithCopies(const Site& site) {
+  std::size_t ret { std::string(site.getName()).size() };
+
+  for (const auto* pGame : site.viewCashGames()) {
+    ret += std::string(pGame->getName()).size() + std::string(pGame->getId()).size();
+    const auto handsView { pGame->viewHands() };
+
+    for (const auto* pHand : std::vector<const Hand*>(handsView.begin(), handsView.end())) {
+      ret += pHand->getId().toString().size() + std::string(pHand->getTableName()).size()
+             + std::string(pHand->getSiteName()).size();
+      const auto seats { pHand->getSeats() };
+      std::vector<std::string> playerNames;
+
+      for (const auto playerId : seats) { playerNames.emplace_back(stringPool::view(playerId)); }
+
+      for (const auto& playerName : playerNames) {
+        // the former isPlayerInvolved(), comparing the names of the actions
+        ret += std::ranges::count_if(pHand->viewActions(), [&playerName](const Action & action) {
+          return playerName == std::string(action.getPlayerName());
+        });
+      }
+    }
+  }
+
+  for (const auto* pPlayer : site.viewPlayers()) { ret += std::string(pPlayer->getName()).size(); }
+
+  return ret;
+}
+
+[[nodiscard]] static std::size_t readWithViews(const Site& site) {
+  std::size_t ret { site.getName().size() };
+
+  for (const auto* pGame : site.viewCashGames()) {
+    ret += pGame->getName().size() + pGame->getId().size();
+
+    for (const auto* pHand : pGame->viewHands()) {
+      ret += static_cast<std::size_t>(HandId {} != pHand->getId()) + pHand->getTableName().size() + pHand->getSiteName().size();
+
+      for (const auto playerId : pHand->getSeats()) {
+        ret += static_cast<std::size_t>(pHand->isPlayerInvolved(playerId)) + stringPool::view(playerId).size();
+      }
+    }
+  }
+
+  for (const auto* pPlayer : site.viewPlayers()) { ret += pPlayer->getName().size(); }
+
+  return ret;
+}
+
+void benchmark::runAccessorBenchmark(std::size_t nbPasses) {
+  static constexpr int NB_RUNS { 3 };
+  const auto pSite { WinamaxGameHistory::parseGameHistory(HISTORY_FILE) };
+  const auto nbBytes { std::filesystem::file_size(HISTORY_FILE) * nbPasses };
+  std::size_t checksum { 0 };
+  const auto run { [&](std::string_view label, auto read) {
+    const auto nbAllocationsBefore { getNbAllocations() };
+    measure(label, nbBytes, NB_RUNS, [&] {
+      for (std::size_t i { 0 }; i < nbPasses; ++i) { checksum += read(*pSite); }
+    });
+    std::println("{:<48} {:>10.1f} allocations per pass", "", static_cast<double>(getNbAllocations() - nbAllocationsBefore)
+                 / static_cast<double>(nbPasses * NB_RUNS));
+  } };
+  std::println("reading the parsed data {} times", nbPasses);
+  run("copying getters", readWithCopies);
+  run("viewing getters", readWithViews);
+  std::println("checksum {}", checksum);
+}
@@ -0,0 +1,85 @@
+module;
+
+export module benchmark.Tools;
+
+#pragma warning( push )
+#pragma warning( disable : 4686)
+import std;
+#pragma warning( pop )
+
+export namespace benchmark {
+/**
+ * The history file used as the benchmarks input.
+ */
+inline const std::filesystem::path HISTORY_FILE { TEST_RESOURCES_DIR "20190206_Colorado_real_holdem_no-limit.txt" };
+
+/**
+ * Creates, if needed, a file in the temporary directory made of HISTORY_FILE repeated until the
+ * given size is reached.
+ * @returns the created file path.
+ */
+[[nodiscard]] std::filesystem::path makeScaledHistoryFile(std::size_t minimumSize);
+
+/**
+ * @returns the number of calls to operator new since the program start, on all threads.
+ */
+[[nodiscard]] std::size_t getNbAllocations() noexcept;
+
+/**
+ * Runs the given function nbRuns times and prints the fastest duration and throughput.
+ * @returns the fastest duration.
+ */
+template<typename FUNCTION>
+std::chrono::nanoseconds measure(std::string_view label, std::size_t nbBytes, int nbRuns,
+                                 FUNCTION&& f) {
+  auto best { std::chrono::nanoseconds::max() };
+
+  for (int i { 0 }; i < nbRuns; ++i) {
+    const auto start { std::chrono::steady_clock::now() };
+    f();
+    best = std::min(best, std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start));
+  }
+
+  const auto seconds { std::chrono::duration<double>(best).count() };
+  std::println("{:<48} {:>10.3f} ms {:>10.1f} MiB/s", label, seconds * 1000.0,
+               static_cast<double>(nbBytes) / (1024.0 * 1024.0) / seconds);
+  return best;
+}
+} // namespace benchmark
+
+module : private;
+
+static std::atomic_size_t s_nbAllocations { 0 };
+
+// the replacements of the global operator new and delete, which the other forms call, counting
+// the allocations. They are attached to the global module, as the functions they replace.
+extern "C++" {
+void* operator new(std::size_t size) {
+  s_nbAllocations.fetch_add(1, std::memory_order_relaxed);
+
+  if (const auto p { std::malloc(std::max<std::size_t>(1, size)) }; nullptr != p) { return p; }
+
+  throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+} // extern "C++"
+
+std::size_t benchmark::getNbAllocations() noexcept { return s_nbAllocations.load(std::memory_order_relaxed); }
+
+std::filesystem::path benchmark::makeScaledHistoryFile(std::size_t minimumSize) {
+  const auto ret { std::filesystem::temp_directory_path() / std::format("prm_benchmark_{}.txt", minimumSize) };
+
+  if (std::error_code ec; std::filesystem::file_size(ret, ec) >= minimumSize and !ec) { return ret; }
+
+  std::ifstream in { HISTORY_FILE, std::ios::binary };
+  const std::string content { std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>() };
+  std::ofstream out { ret, std::ios::binary | std::ios::trunc };
+
+  for (std::size_t written { 0 }; written < minimumSize; written += content.size()) {
+    out.write(content.data(), static_cast<std::streamsize>(content.size()));
+  }
+
+  return ret;
+}
@@ -0,0 +1,78 @@
+module;
+
+export module benchmark.LineScanner;
+
+import benchmark.Tools;
+import system.LineScanner;
+import system.MappedFile;
+import system.TextFile;
+
+#pragma warning( push )
+#pragma warning( disable : 4686)
+import std;
+#pragma warning( pop )
+
+export namespace benchmark {
+/**
+ * Compares the former std::getline based line reading with TextFile and each LineScanner
+ * on HISTORY_FILE scaled up to the given size.
+ */
+void runLineScannerBenchmark(std::size_t fileSize);
+} // namespace benchmark
+
+module : private;
+
+// how TextFile used to read lines: a copy in a string, another in a stringstream, one per line
+[[nodiscard]] static std::size_t countLinesWithGetline(const std::filesystem::path& file) {
+  std::ifstream in { file, std::ios::binary };
+  std::string content { std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>() };
+  std::stringstream ss { std::move(content) };
+  std::string line;
+  std::size_t ret { 0 };
+
+  while (std::getline(ss, line)) { ++ret; }
+
+  return ret;
+}
+
+[[nodiscard]] static std::size_t countLinesWithScanner(std::string_view text, LineScanner scanner) {
+  std::size_t ret { 0 };
+
+  for (auto pos { lineScanner::findNewline(scanner, text, 0) }; std::string_view::npos != pos;
+       pos = lineScanner::findNewline(scanner, text, pos + 1)) {
+    ++ret;
+  }
+
+  return ret;
+}
+
+[[nodiscard]] static std::size_t countLinesWithTextFile(const std::filesystem::path& file, TextFileMode mode) {
+  TextFile tf { file, mode };
+  std::size_t ret { 0 };
+
+  while (tf.next()) { ++ret; }
+
+  return ret;
+}
+
+void benchmark::runLineScannerBenchmark(std::size_t fileSize) {
+  static constexpr int NB_RUNS { 3 };
+  const auto file { makeScaledHistoryFile(fileSize) };
+  const auto nbBytes { std::filesystem::file_size(file) };
+  std::println("line scanning of {} ({} bytes), best scanner is {}", file.string(), nbBytes,
+               lineScanner::toString(lineScanner::best()));
+  std::size_t nbLines { 0 };
+  measure("ifstream + stringstream + std::getline", nbBytes, NB_RUNS, [&] { nbLines = countLinesWithGetline(file); });
+  const MappedFile mapping { file };
+
+  for (const auto scanner : { LineScanner::scalar, LineScanner::sse2, LineScanner::avx2 }) {
+    if (lineScanner::isSupported(scanner)) {
+      measure(std::format("mapped file + {} scanner", lineScanner::toString(scanner)), nbBytes, NB_RUNS,
+      [&] { std::ignore = countLinesWithScanner(mapping.view(), scanner); });
+    }
+  }
+
+  measure("TextFile memoryMapped", nbBytes, NB_RUNS, [&] { std::ignore = countLinesWithTextFile(file, TextFileMode::memoryMapped); });
+  measure("TextFile streamed", nbBytes, NB_RUNS, [&] { std::ignore = countLinesWithTextFile(file, TextFileMode::streamed); });
+  std::println("{} lines", nbLines);
+}
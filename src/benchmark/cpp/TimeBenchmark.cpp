@@ -0,0 +1,89 @@
+module;
+
+export module benchmark.Time;
+
+import benchmark.Tools;
+import system.Time;
+
+#pragma warning( push )
+#pragma warning( disable : 4686)
+import std;
+#pragma warning( pop )
+
+export namespace benchmark {
+/**
+ * Compares the former std::get_time based Time, holding a heap allocated std::tm, with the
+ * current one on the hand start dates of HISTORY_FILE, repeated nbTimes times.
+ */
+void runTimeBenchmark(std::size_t nbTimes);
+} // namespace benchmark
+
+module : private;
+
+static constexpr std::string_view WINAMAX_TIME_FORMAT { "%Y/%m/%d %H:%M:%S" };
+
+// how Time used to be: a std::tm on the heap, parsed through a stringstream
+class [[nodiscard]] FormerTime final {
+private:
+  std::unique_ptr<std::tm> m_pTimeData;
+
+public:
+  explicit FormerTime(std::string_view strTime)
+    : m_pTimeData { std::make_unique<std::tm>() } {
+    std::istringstream iss { std::string(strTime) };
+    iss >> std::get_time(m_pTimeData.get(), WINAMAX_TIME_FORMAT.data());
+
+    if (iss.fail()) { throw std::format("The string '{}' is not a valid time.", strTime); }
+  }
+};
+
+// the dates of the "Winamax Poker - ... - 2019/02/06 20:37:58 UTC" lines
+[[nodiscard]] static std::vector<std::string> readHandStartDates() {
+  std::ifstream in { benchmark::HISTORY_FILE, std::ios::binary };
+  std::vector<std::string> ret;
+
+  for (std::string line; std::getline(in, line);) {
+    if (const auto endPos { line.rfind(" UTC") }; line.starts_with("Winamax Poker") and std::string::npos != endPos) {
+      const auto datePos { line.rfind(" - ", endPos) + 3 };
+      ret.push_back(line.substr(datePos, endPos - datePos));
+    }
+  }
+
+  return ret;
+}
+
+void benchmark::runTimeBenchmark(std::size_t nbTimes) {
+  static constexpr int NB_RUNS { 3 };
+  const auto dates { readHandStartDates() };
+
+  if (dates.empty()) { return; }
+
+  std::vector<std::string_view> input;
+  input.reserve(nbTimes);
+
+  for (std::size_t i { 0 }; i < nbTimes; ++i) { input.emplace_back(dates[i % dates.size()]); }
+
+  const auto nbBytes { std::transform_reduce(input.begin(), input.end(), std::size_t { 0 }, std::plus {},
+  [](std::string_view s) { return s.size(); }) };
+  std::println("parsing of {} times, {} bytes per former Time (+{} on the heap), {} bytes per Time", nbTimes,
+               sizeof(FormerTime), sizeof(std::tm), sizeof(Time));
+  measure("get_time + heap allocated std::tm", nbBytes, NB_RUNS, [&] {
+    std::vector<FormerTime> times;
+    times.reserve(input.size());
+
+    for (const auto s : input) { times.emplace_back(s); }
+  });
+  measure("fixed format parser", nbBytes, NB_RUNS, [&] {
+    std::vector<Time> times;
+    times.reserve(input.size());
+
+    for (const auto s : input) { times.emplace_back(Time::Params { .strTime = s, .format = WINAMAX_TIME_FORMAT }); }
+  });
+  measure("get_time fallback", nbBytes, NB_RUNS, [&] {
+    std::vector<Time> times;
+    times.reserve(input.size());
+
+    // the same format, seen as a generic one because of the trailing space
+    for (const auto s : input) { times.emplace_back(Time::Params { .strTime = s, .format = "%Y/%m/%d %H:%M:%S " }); }
+  });
+}
@@ -0,0 +1,15 @@
+import benchmark.Accessors;
+import benchmark.LineScanner;
+import benchmark.Time;
+
+import std;
+
+// usage: benchmarks [size of the scaled history file in MiB, 1024 by default]
+[[nodiscard]] int main(int argc, char* argv[]) {
+  const std::span args { argv, static_cast<std::size_t>(argc) };
+  const std::size_t sizeInMiB { 1 < args.size() ? std::stoul(args[1]) : 1024 };
+  benchmark::runLineScannerBenchmark(sizeInMiB * 1024 * 1024);
+  benchmark::runTimeBenchmark(1'000'000);
+  benchmark::runAccessorBenchmark(1'000);
+  return 0;
+}
@@ -5,6 +5,8 @@ module;
 export module entities.Action;
 
 import language.Map;
+import system.Money;
+import system.StringPool;
 
 import std;
 
@@ -19,58 +21,52 @@ export enum /*[[nodiscard]]*/ class ActionType : short { none, fold, check, call
 export enum class /*[[nodiscard]]*/ Street : short { none, preflop, flop, turn, river };
 
 /**
- * The elementary move of a player.
+ * The elementary move of a player. A small trivially copyable record, that hands store by value.
  */
 export class [[nodiscard]] Action final {
 private:
-  std::string m_handId;
-  std::string m_playerName;
+  Money m_betAmount;
+  PlayerId m_playerId;
+  std::uint32_t m_index; // in the street
   Street m_street;
   ActionType m_type;
-  std::size_t m_index;
-  double m_betAmount;
 
 public:
 
   struct [[nodiscard]] Params final {
-    std::string_view handId;
-    std::string_view playerName;
+    PlayerId playerId;
     Street street;
     ActionType type;
     std::size_t actionIndex;
-    double betAmount;
+    Money betAmount;
   };
 
   explicit Action(const Params& p)
-    : m_handId { p.handId },
-      m_playerName { p.playerName },
+    : m_betAmount { p.betAmount },
+      m_playerId { p.playerId },
+      m_index { static_cast<std::uint32_t>(p.actionIndex) },
       m_street { p.street },
-      m_type { p.type },
-      m_index { p.actionIndex },
-      m_betAmount { p.betAmount } {
+      m_type { p.type } {
     assert(Street::none != m_street);
-    assert(!m_handId.empty());
-    assert(!m_playerName.empty());
-    assert(m_betAmount >= 0);
+    assert(PlayerId::none != m_playerId);
+    assert(m_betAmount >= Money {});
   }
 
-  Action(const Action&) = delete;
-  Action(Action&&) = delete;
-  Action& operator=(const Action&) = delete;
-  Action& operator=(Action&&) = delete;
-  ~Action() = default;
   [[nodiscard]] Street getStreet() const noexcept { return m_street; }
-  [[nodiscard]] std::string getHandId() const noexcept { return m_handId; }
-  [[nodiscard]] std::string getPlayerName() const noexcept { return m_playerName; }
+  [[nodiscard]] PlayerId getPlayerId() const noexcept { return m_playerId; }
+  [[nodiscard]] std::string_view getPlayerName() const noexcept { return stringPool::view(m_playerId); }
   [[nodiscard]] ActionType getType() const noexcept { return m_type; }
   [[nodiscard]] std::size_t getIndex() const noexcept { return m_index; }
-  [[nodiscard]] double getBetAmount() const noexcept { return m_betAmount; }
+  [[nodiscard]] Money getBetAmount() const noexcept { return m_betAmount; }
 }; // class Action
 
 export [[nodiscard]] std::string_view toString(ActionType at);
 export [[nodiscard]] std::string_view toString(Street st);
 
 module : private;
+
+static_assert(std::is_trivially_copyable_v<Action> and 24 == sizeof(Action));
+
 // exported methods
 [[nodiscard]] std::string_view toString(ActionType at) {
   static constexpr auto ACTION_TYPE_TO_STRING = language::Map<ActionType, std::string_view, 6> {{{
@@ -66,8 +66,91 @@ export enum class /*[[nodiscard]]*/ Card : short {
 };
 
 export [[nodiscard]] std::string_view toString(Card c);
+
+/**
+ * @returns the card named as in the history files ("Ah", "Td"...), or "none" or "back".
+ * @throws std::range_error for an unknown name
+ */
 export [[nodiscard]] Card toCard(std::string_view strCard);
 
+inline constexpr std::size_t NB_RANKS { 13 };
+
+// the index of each character in the given ones, -1 for the other characters
+[[nodiscard]] consteval std::array<signed char, 256> makeCharIndexes(std::string_view chars) {
+  std::array<signed char, 256> ret;
+  ret.fill(-1);
+
+  for (std::size_t i { 0 }; i < chars.size(); ++i) { ret[static_cast<unsigned char>(chars[i])] = static_cast<signed char>(i); }
+
+  return ret;
+}
+
+inline constexpr auto RANK_INDEXES { makeCharIndexes("23456789TJQKA") };
+inline constexpr auto SUIT_INDEXES { makeCharIndexes("shdc") }; // in the Card order
+
+/**
+ * @returns the card of the given rank ('2' to '9', 'T', 'J', 'Q', 'K' or 'A') and suit ('s', 'h',
+ * 'd' or 'c'), or Card::none if one of them is unknown.
+ */
+export [[nodiscard]] constexpr Card toCard(char rank, char suit) noexcept {
+  const auto rankIndex { RANK_INDEXES[static_cast<unsigned char>(rank)] };
+  const auto suitIndex { SUIT_INDEXES[static_cast<unsigned char>(suit)] };
+  return (0 > rankIndex or 0 > suitIndex) ? Card::none
+         : static_cast<Card>(1 + suitIndex * static_cast<int>(NB_RANKS) + rankIndex);
+}
+
+/**
+ * A set of cards, as a 64 bits mask: a group of 13 bits per suit, in the Card order.
+ * Card::none and Card::back are never part of a set.
+ */
+export class [[nodiscard]] CardSet final {
+private:
+  static constexpr std::uint64_t SUIT_MASK { (std::uint64_t { 1 } << NB_RANKS) - 1 };
+  std::uint64_t m_mask { 0 };
+
+  [[nodiscard]] static constexpr std::uint64_t toBit(Card c) noexcept {
+    return (Card::none == c or Card::back == c) ? 0 : std::uint64_t { 1 } << (std::to_underlying(c) - 1);
+  }
+
+  [[nodiscard]] constexpr std::uint64_t getSuit(std::size_t suitIndex) const noexcept {
+    return (m_mask >> (suitIndex * NB_RANKS)) & SUIT_MASK;
+  }
+
+public:
+  constexpr CardSet() noexcept = default;
+
+  explicit constexpr CardSet(std::span<const Card> cards) noexcept {
+    for (const auto c : cards) { add(c); }
+  }
+
+  constexpr void add(Card c) noexcept { m_mask |= toBit(c); }
+  [[nodiscard]] constexpr bool contains(Card c) const noexcept { return 0 != (m_mask & toBit(c)); }
+  [[nodiscard]] constexpr int size() const noexcept { return std::popcount(m_mask); }
+  [[nodiscard]] constexpr bool empty() const noexcept { return 0 == m_mask; }
+  [[nodiscard]] constexpr std::uint64_t getMask() const noexcept { return m_mask; }
+  [[nodiscard]] constexpr bool operator==(const CardSet&) const noexcept = default;
+
+  /**
+   * @returns the number of cards of the most represented suit.
+   */
+  [[nodiscard]] constexpr int getMaxNbCardsOfASuit() const noexcept {
+    return std::max({ std::popcount(getSuit(0)), std::popcount(getSuit(1)), std::popcount(getSuit(2)),
+                      std::popcount(getSuit(3)) });
+  }
+
+  /**
+   * @returns true if at least two cards have the same rank.
+   */
+  [[nodiscard]] constexpr bool isPaired() const noexcept {
+    return std::popcount(getSuit(0) | getSuit(1) | getSuit(2) | getSuit(3)) < size();
+  }
+
+  /**
+   * @returns true if, seen as a board, the set allows a flush: three cards of the same suit.
+   */
+  [[nodiscard]] constexpr bool isFlushPossible() const noexcept { return 3 <= getMaxNbCardsOfASuit(); }
+}; // class CardSet
+
 export namespace cardImages {
 std::tuple<unsigned char*, unsigned int> getImage(Card card);
 } // namespace cardImages
@@ -31588,63 +31671,22 @@ std::string_view toString(Card c) {
 }
 
 Card toCard(std::string_view strCard) {
-  static constexpr auto STRING_TO_ENUM = language::makeMap<std::string_view, Card>(
-    std::make_pair( "none", Card::none ),
-    std::make_pair( "2s", Card::twoSpade ),
-    std::make_pair( "3s", Card::threeSpade ),
-    std::make_pair( "4s", Card::fourSpade ),
-    std::make_pair( "5s", Card::fiveSpade ),
-    std::make_pair( "6s", Card::sixSpade ),
-    std::make_pair( "7s", Card::sevenSpade ),
-    std::make_pair( "8s", Card::eightSpade ),
-    std::make_pair( "9s", Card::nineSpade ),
-    std::make_pair( "Ts", Card::tenSpade ),
-    std::make_pair( "Js", Card::jackSpade ),
-    std::make_pair( "Qs", Card::queenSpade ),
-    std::make_pair( "Ks", Card::kingSpade ),
-    std::make_pair( "As", Card::aceSpade ),
-    std::make_pair( "2h", Card::twoHeart ),
-    std::make_pair( "3h", Card::threeHeart ),
-    std::make_pair( "4h", Card::fourHeart ),
-    std::make_pair( "5h", Card::fiveHeart ),
-    std::make_pair( "6h", Card::sixHeart ),
-    std::make_pair( "7h", Card::sevenHeart ),
-    std::make_pair( "8h", Card::eightHeart ),
-    std::make_pair( "9h", Card::nineHeart ),
-    std::make_pair( "Th", Card::tenHeart ),
-    std::make_pair( "Jh", Card::jackHeart ),
-    std::make_pair( "Qh", Card::queenHeart ),
-    std::make_pair( "Kh", Card::kingHeart ),
-    std::make_pair( "Ah", Card::aceHeart ),
-    std::make_pair( "2d", Card::twoDiamond ),
-    std::make_pair( "3d", Card::threeDiamond ),
-    std::make_pair( "4d", Card::fourDiamond ),
-    std::make_pair( "5d", Card::fiveDiamond ),
-    std::make_pair( "6d", Card::sixDiamond ),
-    std::make_pair( "7d", Card::sevenDiamond ),
-    std::make_pair( "8d", Card::eightDiamond ),
-    std::make_pair( "9d", Card::nineDiamond ),
-    std::make_pair( "Td", Card::tenDiamond ),
-    std::make_pair( "Jd", Card::jackDiamond ),
-    std::make_pair( "Qd", Card::queenDiamond ),
-    std::make_pair( "Kd", Card::kingDiamond ),
-    std::make_pair( "Ad", Card::aceDiamond ),
-    std::make_pair( "2c", Card::twoClub ),
-    std::make_pair( "3c", Card::threeClub ),
-    std::make_pair( "4c", Card::fourClub ),
-    std::make_pair( "5c", Card::fiveClub ),
-    std::make_pair( "6c", Card::sixClub ),
-    std::make_pair( "7c", Card::sevenClub ),
-    std::make_pair( "8c", Card::eightClub ),
-    std::make_pair( "9c", Card::nineClub ),
-    std::make_pair( "Tc", Card::tenClub ),
-    std::make_pair( "Jc", Card::jackClub ),
-    std::make_pair( "Qc", Card::queenClub ),
-    std::make_pair( "Kc", Card::kingClub ),
-    std::make_pair( "Ac", Card::aceClub ),
-    std::make_pair( "back", Card::back )
-  );
-  return STRING_TO_ENUM.at(strCard);
-}
+  if (2 == strCard.size()) {
+    if (const auto ret { toCard(strCard[0], strCard[1]) }; Card::none != ret) { return ret; }
+  }
+
+  if ("none" == strCard) { return Card::none; }
 
+  if ("back" == strCard) { return Card::back; }
+
+  throw std::range_error("Key Not Found in Map");
+}
 
+static_assert(Card::twoSpade == toCard('2', 's'));
+static_assert(Card::tenHeart == toCard('T', 'h'));
+static_assert(Card::aceClub == toCard('A', 'c'));
+static_assert(Card::none == toCard('1', 'c'));
+static_assert(CardSet(std::array { Card::twoSpade, Card::twoHeart, Card::aceClub }).isPaired());
+static_assert(!CardSet(std::array { Card::twoSpade, Card::threeSpade, Card::aceClub }).isPaired());
+static_assert(CardSet(std::array { Card::twoSpade, Card::threeSpade, Card::aceSpade }).isFlushPossible());
+static_assert(!CardSet(std::array { Card::twoSpade, Card::threeSpade, Card::none, Card::back }).isFlushPossible());
@@ -5,8 +5,12 @@ module;
 export module entities.Game;
 
 import entities.Hand;
+import entities.HandId;
 import entities.Seat;
 import language.Map;
+import system.MemoryArena;
+import system.Money;
+import system.StringPool;
 import system.Time;
 
 import std;
@@ -27,6 +31,8 @@ export enum class /*[[nodiscard]]*/ Limit : short {
 
 /**
  * A game.
+ * The getters return views on the game data: the strings, and the hands through viewHands(), are
+ * valid as long as the game exists, and the hands until hands are added to or moved out of it.
  */
 export class [[nodiscard]] Game {
 private:
@@ -38,7 +44,11 @@ private:
   bool m_isRealMoney;
   Seat m_nbMaxSeats;
   Time m_startDate;
-  std::vector<std::unique_ptr<Hand>> m_hands;
+  // the arenas holding the hands, declared first so that they are destroyed after the hands
+  std::vector<std::shared_ptr<MemoryArena>> m_arenas;
+  std::vector<ArenaPtr<Hand>> m_hands;
+  // the ids of m_hands, so that a merge only looks up the ids of the hands it brings
+  std::unordered_set<HandId> m_handIds;
 
 public:
 
@@ -62,7 +72,9 @@ public:
       m_isRealMoney { args.isRealMoney },
       m_nbMaxSeats { args.nbMaxSeats },
       m_startDate { args.startDate },
-      m_hands {} {
+      m_arenas {},
+      m_hands {},
+      m_handIds {} {
     assert(!m_id.empty());
     assert(!m_site.empty());
     assert(!m_name.empty());
@@ -74,16 +86,55 @@ public:
   Game& operator=(Game&&) = delete;
   ~Game() = default;
 
-  void addHand(std::unique_ptr<Hand> hand) { m_hands.push_back(std::move(hand)); }
+  /**
+   * Adds a hand created in the given arena, which is kept until this game is destroyed. A hand
+   * having the id of a hand of this game is dropped.
+   */
+  void addHand(ArenaPtr<Hand> hand, const std::shared_ptr<MemoryArena>& pArena);
 
-  // gcc 10.2 can't do constexpr std::string
-  [[nodiscard]] /*constexpr*/ std::string getName() const noexcept { return m_name; }
+  /**
+   * Moves the hands of this game, and their arenas, into the given game, dropping the hands that
+   * the given game already has.
+   * @returns the number of hands dropped
+   */
+  std::size_t moveHandsInto(Game& other);
+
+  /**
+   * Removes the hands for which isRemoved(const Hand&) is true, keeping the order of the other
+   * hands. isRemoved is called once per hand, in the hands order.
+   * @returns the number of hands removed
+   */
+  std::size_t removeHandsIf(auto&& isRemoved) {
+    std::size_t nbKept { 0 };
+
+    for (auto& pHand : m_hands) {
+      if (!isRemoved(std::as_const(*pHand))) { m_hands[nbKept++] = std::move(pHand); }
+      else { m_handIds.erase(pHand->getId()); }
+    }
+
+    const auto ret { m_hands.size() - nbKept };
+    m_hands.resize(nbKept);
+    return ret;
+  }
+
+  [[nodiscard]] std::string_view getName() const noexcept { return m_name; }
   [[nodiscard]] constexpr bool isRealMoney() const noexcept { return m_isRealMoney; }
   [[nodiscard]] Time getStartDate() const noexcept { return m_startDate; }
-  [[nodiscard]] std::vector<const Hand*> viewHands() const;
+
+  /**
+   * @returns a random access range of const Hand*, in the order the hands were added.
+   */
+  [[nodiscard]] auto viewHands() const noexcept {
+    return m_hands | std::views::transform([](const ArenaPtr<Hand>& pHand) -> const Hand* { return pHand.get(); });
+  }
+
+  /**
+   * @returns a copy of the hands where the given player has an action.
+   */
   [[nodiscard]] std::vector<const Hand*> viewHands(std::string_view player) const;
-  [[nodiscard]] /*constexpr*/ std::string getSiteName() const noexcept { return m_site; }
-  [[nodiscard]] /*constexpr*/ std::string getId() const noexcept { return m_id; }
+  [[nodiscard]] std::size_t getNbHands() const noexcept { return m_hands.size(); }
+  [[nodiscard]] std::string_view getSiteName() const noexcept { return m_site; }
+  [[nodiscard]] std::string_view getId() const noexcept { return m_id; }
   [[nodiscard]] constexpr Variant getVariant() const noexcept { return m_variant; }
   [[nodiscard]] constexpr Limit getLimitType() const noexcept { return m_limitType; }
   [[nodiscard]] constexpr Seat getMaxNbSeats() const noexcept { return m_nbMaxSeats; }
@@ -91,7 +142,7 @@ public:
 
 export class [[nodiscard]] Tournament final : public Game {
 private:
-  double m_buyIn;
+  Money m_buyIn;
 
 public:
 
@@ -103,7 +154,7 @@ public:
     Limit limit;
     bool isRealMoney;
     Seat nbMaxSeats;
-    double buyIn;
+    Money buyIn;
     const Time& startDate;
   };
 
@@ -112,20 +163,20 @@ public:
                         .variant = p.variant, .limitType = p.limit, .isRealMoney = p.isRealMoney,
                         .nbMaxSeats = p.nbMaxSeats, .startDate = p.startDate }),
     m_buyIn { p.buyIn } {
-    assert(m_buyIn >= 0 and "negative buyIn");
+    assert(m_buyIn >= Money {} and "negative buyIn");
   }
   Tournament(const Tournament&) = delete;
   Tournament(Tournament&&) = delete;
   Tournament& operator=(const Tournament&) = delete;
   Tournament& operator=(Tournament&&) = delete;
   ~Tournament() = default;
-  [[nodiscard]] constexpr double getBuyIn() const noexcept { return m_buyIn; }
+  [[nodiscard]] constexpr Money getBuyIn() const noexcept { return m_buyIn; }
 }; // class Tournament
 
 export class [[nodiscard]] CashGame final : public Game {
 private:
-  double m_smallBlind;
-  double m_bigBlind;
+  Money m_smallBlind;
+  Money m_bigBlind;
 
 public:
 
@@ -137,8 +188,8 @@ public:
     Limit limit;
     bool isRealMoney;
     Seat nbMaxSeats;
-    double smallBlind;
-    double bigBlind;
+    Money smallBlind;
+    Money bigBlind;
     const Time& startDate;
   };
 
@@ -148,8 +199,8 @@ public:
                         .nbMaxSeats = p.nbMaxSeats, .startDate = p.startDate }),
     m_smallBlind { p.smallBlind },
     m_bigBlind { p.bigBlind } {
-    assert(m_smallBlind >= 0 and "negative small blind");
-    assert(m_bigBlind >= 0 and "negative big blind");
+    assert(m_smallBlind >= Money {} and "negative small blind");
+    assert(m_bigBlind >= Money {} and "negative big blind");
   }
 
   CashGame(const CashGame&) = delete;
@@ -157,8 +208,8 @@ public:
   CashGame& operator=(const CashGame&) = delete;
   CashGame& operator=(CashGame&&) = delete;
   ~CashGame() = default;
-  [[nodiscard]] constexpr double getSmallBlind() const noexcept { return m_smallBlind; }
-  [[nodiscard]] constexpr double getBigBlind() const noexcept { return m_bigBlind; }
+  [[nodiscard]] constexpr Money getSmallBlind() const noexcept { return m_smallBlind; }
+  [[nodiscard]] constexpr Money getBigBlind() const noexcept { return m_bigBlind; }
 }; // class CashGame
 
 export [[nodiscard]] std::string_view toString(Variant variant);
@@ -166,15 +217,44 @@ export [[nodiscard]] std::string_view toString(Limit limitType);
 
 module : private;
 
-std::vector<const Hand*> Game::viewHands() const {
-  std::vector<const Hand*> ret;
-  std::ranges::transform(m_hands, std::back_inserter(ret), [&](const auto & h) { return h.get(); });
+void Game::addHand(ArenaPtr<Hand> hand, const std::shared_ptr<MemoryArena>& pArena) {
+  assert(nullptr != pArena and "a hand needs its arena");
+
+  // a game has a few arenas, one per parsing thread of its history file
+  if (m_arenas.end() == std::ranges::find(m_arenas, pArena)) { m_arenas.push_back(pArena); }
+
+  if (m_handIds.insert(hand->getId()).second) { m_hands.push_back(std::move(hand)); }
+}
+
+std::size_t Game::moveHandsInto(Game& other) {
+  assert(this != &other and "can't move hands into the same game");
+  std::ranges::for_each(m_arenas, [&other](auto & pArena) {
+    if (other.m_arenas.end() == std::ranges::find(other.m_arenas, pArena)) { other.m_arenas.push_back(std::move(pArena)); }
+  });
+  m_arenas.clear();
+  other.m_hands.reserve(other.m_hands.size() + m_hands.size());
+  std::size_t ret { 0 };
+
+  for (auto& pHand : m_hands) {
+    if (other.m_handIds.insert(pHand->getId()).second) { other.m_hands.push_back(std::move(pHand)); }
+    else { ++ret; }
+  }
+
+  m_hands.clear();
+  m_handIds.clear();
   return ret;
 }
 
 std::vector<const Hand*> Game::viewHands(std::string_view player) const {
   std::vector<const Hand*> ret;
-  std::ranges::for_each(m_hands, [&](const auto & h) { if (h->isPlayerInvolved(player)) { ret.push_back(h.get()); } });
+
+  // a player who was never interned can't be in any hand
+  if (const auto oPlayerId { stringPool::findPlayer(player) }; oPlayerId.has_value()) {
+    std::ranges::for_each(m_hands, [&](const auto & h) {
+      if (h->isPlayerInvolved(oPlayerId.value())) { ret.push_back(h.get()); }
+    });
+  }
+
   return ret;
 }
 
@@ -7,17 +7,26 @@ export module entities.Hand;
 import entities.Action;
 import entities.Card;
 import entities.GameType;
+import entities.HandId;
 import entities.Seat;
+import system.StringPool;
 import system.Time;
 
 import std;
 
+/**
+ * A hand, created in a MemoryArena with the other hands of its history file. Its actions are in the
+ * same arena, and are released with it.
+ */
 export class [[nodiscard]] Hand final {
+public:
+  using allocator_type = std::pmr::polymorphic_allocator<>;
+
 private:
-  std::string m_id;
+  HandId m_id;
   GameType m_gameType;
-  std::string m_siteName;
-  std::string m_tableName;
+  StringId m_siteName;
+  StringId m_tableName;
   Seat m_buttonSeat;
   Seat m_maxSeats;
   int m_level;
@@ -25,13 +34,43 @@ private:
   Time m_date;
   std::array<Card, 5> m_heroCards;
   std::array<Card, 5> m_boardCards;
-  std::unordered_map<Seat, std::string> m_seats;
-  std::vector<std::unique_ptr<Action>> m_actions;
-  std::array<std::string, 10> m_winners;
+  CardSet m_heroCardSet;
+  CardSet m_boardCardSet;
+  std::array<PlayerId, 10> m_seats; // indexed by tableSeat::toArrayIndex(), PlayerId::none for an empty seat
+  // a bit per seat, the bit i being for the seat tableSeat::fromArrayIndex(i)
+  std::uint16_t m_occupiedSeats;
+  std::uint16_t m_winnerSeats;
+  std::uint16_t m_involvedSeats; // the seats of the players having an action
+  std::span<const Action> m_actions; // in the memory of the allocator given to the constructor
+
+  [[nodiscard]] static std::span<const Action> copyActions(std::span<const Action> actions,
+      allocator_type allocator) {
+    if (actions.empty()) { return {}; }
+
+    const auto pActions { allocator.allocate_object<Action>(actions.size()) };
+    std::ranges::uninitialized_copy(actions, std::span { pActions, actions.size() });
+    return { pActions, actions.size() };
+  }
+
+  // the bit of the seat of player, or 0 if player is not seated. The 10 seats are always all
+  // compared, without a branch, so the cost does not depend on the seat of the player.
+  [[nodiscard]] std::uint16_t getSeatBit(PlayerId player) const noexcept {
+    unsigned ret { 0 };
+
+    for (std::size_t i { 0 }; i < m_seats.size(); ++i) { ret |= static_cast<unsigned>(player == m_seats[i]) << i; }
+
+    return PlayerId::none == player ? 0 : static_cast<std::uint16_t>(ret);
+  }
+
+  [[nodiscard]] std::uint16_t toSeatMask(auto&& players) const noexcept {
+    std::uint16_t ret { 0 };
+    std::ranges::for_each(players, [this, &ret](PlayerId player) { ret |= getSeatBit(player); });
+    return ret;
+  }
 
 public:
   struct [[nodiscard]] Params final {
-    std::string_view id;
+    HandId id;
     GameType gameType;
     std::string_view siteName;
     std::string_view tableName;
@@ -40,18 +79,18 @@ public:
     int level;
     long ante;
     const Time& startDate;
-    const std::unordered_map<Seat, std::string>& seatPlayers;
+    const std::array<PlayerId, 10>& seatPlayers; // indexed by tableSeat::toArrayIndex()
     const std::array<Card, 5>& heroCards;
     const std::array<Card, 5>& boardCards;
-    std::vector<std::unique_ptr<Action>> actions;
-    const std::array<std::string, 10>& winners;
+    std::span<const Action> actions;
+    std::span<const PlayerId> winners;
   }; // struct Params
 
-  explicit Hand(Params& p)
+  Hand(const Params& p, const allocator_type& allocator)
     : m_id { p.id },
       m_gameType { p.gameType },
-      m_siteName { p.siteName },
-      m_tableName { p.tableName },
+      m_siteName { stringPool::intern(p.siteName) },
+      m_tableName { stringPool::intern(p.tableName) },
       m_buttonSeat { p.buttonSeat },
       m_maxSeats { p.maxSeats },
       m_level { p.level },
@@ -59,14 +98,19 @@ public:
       m_date { p.startDate },
       m_heroCards { p.heroCards },
       m_boardCards { p.boardCards },
+      m_heroCardSet { m_heroCards },
+      m_boardCardSet { m_boardCards },
       m_seats { p.seatPlayers },
-      m_actions { std::move(p.actions) },
-      m_winners { p.winners } {
-    assert(!m_id.empty() and "id is empty");
-    assert(!m_siteName.empty() and "site is empty");
-    assert(!m_tableName.empty() and "table is empty");
+      m_occupiedSeats { toSeatMask(m_seats) },
+      m_winnerSeats { toSeatMask(p.winners) },
+      m_involvedSeats { toSeatMask(p.actions | std::views::transform(&Action::getPlayerId)) },
+      m_actions { copyActions(p.actions, allocator) } {
+    assert(StringId::empty != m_siteName and "site is empty");
+    assert(StringId::empty != m_tableName and "table is empty");
     assert(m_ante >= 0 and "ante is negative");
-    assert(m_seats.size() > 1 and m_seats.size() < 11);
+    assert(std::popcount(m_occupiedSeats) > 1 and "less than 2 players");
+    assert(std::ranges::all_of(p.winners, [this](PlayerId winner) { return PlayerId::none == winner or 0 != getSeatBit(winner); })
+           and "a winner has no seat");
   }
 
   Hand(const Hand&) = delete;
@@ -74,18 +118,19 @@ public:
   Hand& operator=(const Hand&) = delete;
   Hand& operator=(Hand&&) = delete;
   ~Hand() = default;
-  [[nodiscard]] std::vector<const Action*> viewActions() const;
-  [[nodiscard]] std::string getId() const noexcept { return m_id; }
+  [[nodiscard]] std::span<const Action> viewActions() const noexcept { return m_actions; }
+  [[nodiscard]] HandId getId() const noexcept { return m_id; }
   [[nodiscard]] GameType getGameType() const noexcept { return m_gameType; }
-  [[nodiscard]] std::string getSiteName() const noexcept { return m_siteName; }
-  [[nodiscard]] std::string getTableName() const noexcept { return m_tableName; }
-  [[nodiscard]] std::unordered_map<Seat, std::string> getSeats() const noexcept { return m_seats; }
+  [[nodiscard]] std::string_view getSiteName() const noexcept { return stringPool::view(m_siteName); }
+  [[nodiscard]] std::string_view getTableName() const noexcept { return stringPool::view(m_tableName); }
+  [[nodiscard]] const std::array<PlayerId, 10>& getSeats() const noexcept { return m_seats; }
+  [[nodiscard]] PlayerId getPlayer(Seat seat) const { return m_seats.at(tableSeat::toArrayIndex(seat)); }
+  [[nodiscard]] std::uint16_t getOccupiedSeats() const noexcept { return m_occupiedSeats; }
   [[nodiscard]] Seat getButtonSeat() const noexcept { return m_buttonSeat; }
   [[nodiscard]] Seat getMaxSeats() const noexcept { return m_maxSeats; }
   [[nodiscard]] int getLevel()const noexcept { return m_level; }
   [[nodiscard]] long getAnte() const noexcept { return m_ante; }
   [[nodiscard]] Time getStartDate() const noexcept { return m_date; }
-  [[nodiscard]] bool isPlayerInvolved(std::string_view name) const;
   [[nodiscard]] Card getHeroCard1() const { return m_heroCards.at(0); }
   [[nodiscard]] Card getHeroCard2() const { return m_heroCards.at(1); }
   [[nodiscard]] Card getHeroCard3() const { return m_heroCards.at(2); }
@@ -96,27 +141,14 @@ public:
   [[nodiscard]] Card getBoardCard3() const { return m_boardCards.at(2); }
   [[nodiscard]] Card getBoardCard4() const { return m_boardCards.at(3); }
   [[nodiscard]] Card getBoardCard5() const { return m_boardCards.at(4); }
-  [[nodiscard]] bool isWinner(std::string_view playerName) const noexcept {
-    return m_winners.end() != std::ranges::find(m_winners, playerName.data());
-  }
-}; // class Hand
-
-module : private;
-
-template<template<typename, typename> typename SmartPointer, typename T, typename U>
-[[nodiscard]] std::vector<const T*> mkView(const std::vector<SmartPointer<T, U>>& v) {
-  std::vector<const T*> ret;
-  ret.reserve(v.size());
-
-  // here we use a 'for' loop to avoid depending on <algorithm>
-  for (const auto& e : v) { ret.push_back(e.get()); }
-
-  return ret;
-}
-
-std::vector<const Action*> Hand::viewActions() const { return mkView(m_actions); }
-
-bool Hand::isPlayerInvolved(std::string_view name) const {
-  return m_actions.end() != std::ranges::find_if(m_actions,
-  [&name](const auto & a) { return name == a->getPlayerName(); });
-}
\ No newline at end of file
+  // the cards as bitboards, for the questions where their order does not matter
+  [[nodiscard]] CardSet getHeroCardSet() const noexcept { return m_heroCardSet; }
+  [[nodiscard]] CardSet getBoardCardSet() const noexcept { return m_boardCardSet; }
+  [[nodiscard]] bool isBoardPaired() const noexcept { return m_boardCardSet.isPaired(); }
+  [[nodiscard]] bool isFlushPossible() const noexcept { return m_boardCardSet.isFlushPossible(); }
+  // the seats of the winners, with the same bits as getOccupiedSeats()
+  [[nodiscard]] std::uint16_t getWinnerSeats() const noexcept { return m_winnerSeats; }
+  [[nodiscard]] bool isWinner(Seat seat) const { return 0 != (m_winnerSeats & (1U << tableSeat::toArrayIndex(seat))); }
+  [[nodiscard]] bool isWinner(PlayerId player) const noexcept { return 0 != (m_winnerSeats & getSeatBit(player)); }
+  [[nodiscard]] bool isPlayerInvolved(PlayerId player) const noexcept { return 0 != (m_involvedSeats & getSeatBit(player)); }
+}; // class Hand
\ No newline at end of file
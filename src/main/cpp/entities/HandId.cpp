@@ -0,0 +1,87 @@
+module;
+
+export module entities.HandId;
+
+#pragma warning( push )
+#pragma warning( disable : 4686)
+import std;
+#pragma warning( pop )
+
+/**
+ * The id of a hand, such as "12266668-4174329-1549487680", as its 3 numbers. The hands are sorted,
+ * searched and deduplicated with integer comparisons instead of string comparisons.
+ */
+export class [[nodiscard]] HandId final {
+private:
+  std::uint64_t m_first { 0 };
+  std::uint32_t m_second { 0 };
+  std::uint32_t m_third { 0 };
+
+public:
+  constexpr HandId() noexcept = default;
+  constexpr HandId(std::uint64_t first, std::uint32_t second, std::uint32_t third) noexcept
+    : m_first { first }, m_second { second }, m_third { third } {}
+
+  /**
+   * Parses an id such as "12266668-4174329-1549487680", without allocating.
+   * @returns std::nullopt if the text is not 3 numbers separated by '-' or if a number is too large.
+   */
+  [[nodiscard]] static constexpr std::optional<HandId> parse(std::string_view id) noexcept {
+    std::array<std::uint64_t, 3> numbers {};
+    std::size_t i { 0 };
+
+    for (std::size_t n { 0 }; n < numbers.size(); ++n) {
+      if (0 < n and (i == id.size() or '-' != id[i++])) { return {}; }
+
+      const auto start { i };
+
+      for (; i < id.size() and '0' <= id[i] and id[i] <= '9' and i - start < 19; ++i) {
+        numbers[n] = numbers[n] * 10 + static_cast<std::uint64_t>(id[i] - '0');
+      }
+
+      if (start == i) { return {}; }
+    }
+
+    if (id.size() != i or std::numeric_limits<std::uint32_t>::max() < numbers[1]
+        or std::numeric_limits<std::uint32_t>::max() < numbers[2]) {
+      return {};
+    }
+
+    return HandId { numbers[0], static_cast<std::uint32_t>(numbers[1]), static_cast<std::uint32_t>(numbers[2]) };
+  }
+
+  [[nodiscard]] constexpr std::uint64_t getFirst() const noexcept { return m_first; }
+  [[nodiscard]] constexpr std::uint32_t getSecond() const noexcept { return m_second; }
+  [[nodiscard]] constexpr std::uint32_t getThird() const noexcept { return m_third; }
+  [[nodiscard]] constexpr auto operator<=>(const HandId&) const noexcept = default;
+
+  [[nodiscard]] constexpr std::size_t hash() const noexcept {
+    // the 3 numbers mixed, the last one being a timestamp shared by the hands of a table
+    auto ret { m_first * 0x9e3779b97f4a7c15ULL ^ (static_cast<std::uint64_t>(m_second) << 32 | m_third) };
+    ret ^= ret >> 29;
+    return static_cast<std::size_t>(ret * 0xbf58476d1ce4e5b9ULL);
+  }
+
+  /**
+   * @returns the id as written in the history files.
+   */
+  [[nodiscard]] std::string toString() const;
+}; // class HandId
+
+template<>
+struct std::hash<HandId> {
+  [[nodiscard]] std::size_t operator()(const HandId& id) const noexcept { return id.hash(); }
+};
+
+module : private;
+
+std::string HandId::toString() const { return std::format("{}-{}-{}", m_first, m_second, m_third); }
+
+static_assert(HandId::parse("12266668-4174329-1549487680") == HandId { 12266668, 4174329, 1549487680 });
+static_assert(HandId::parse("1-2-3") < HandId::parse("1-10-0"));
+static_assert(!HandId::parse("").has_value());
+static_assert(!HandId::parse("1-2").has_value());
+static_assert(!HandId::parse("1-2-3-").has_value());
+static_assert(!HandId::parse("1--3").has_value());
+static_assert(!HandId::parse("1-2-4294967296").has_value());
+static_assert(!HandId::parse("1-2-3 ").has_value());
@@ -8,6 +8,7 @@ import std;
 
 /**
  * A tournament or cashgame poker player.
+ * The getters return views on the player strings, valid as long as the player exists.
  */
 export class [[nodiscard]] Player final {
 private:
@@ -24,11 +25,10 @@ public:
   };
 
   explicit Player(const Params& p);
-  // gcc 10.2 can't do constexpr std::string
-  [[nodiscard]] /*constexpr*/ std::string getName() const noexcept { return m_name; }
-  [[nodiscard]] /*constexpr*/ std::string getPlayerName() const noexcept { return m_name; }
-  [[nodiscard]] /*constexpr*/ std::string getSiteName() const noexcept { return m_site; }
-  [[nodiscard]] /*constexpr*/ std::string getComments() const noexcept { return m_comments; }
+  [[nodiscard]] std::string_view getName() const noexcept { return m_name; }
+  [[nodiscard]] std::string_view getPlayerName() const noexcept { return m_name; }
+  [[nodiscard]] std::string_view getSiteName() const noexcept { return m_site; }
+  [[nodiscard]] std::string_view getComments() const noexcept { return m_comments; }
   [[nodiscard]] constexpr bool isHero() const noexcept { return m_isHero; }
   constexpr void setIsHero(bool isHero) noexcept { m_isHero = isHero; }
 }; // class Player
@@ -19,6 +19,11 @@ export namespace tableSeat {
  */
 [[nodiscard]] Seat fromString(std::string_view seatStr);
 
+/*
+ * Transforms "1" into Seat::SeatOne and so on, or returns std::nullopt for any other string.
+ */
+[[nodiscard]] std::optional<Seat> parse(std::string_view seatStr) noexcept;
+
 /*
  * Transforms 0 into Seat::SeatOne and so on.
  */
@@ -57,6 +62,14 @@ module : private;
   return STRING_TO_ENUM.at(seatStr);
 }
 
+/*[[nodiscard]]*/ std::optional<Seat> tableSeat::parse(std::string_view seatStr) noexcept {
+  if ("10" == seatStr) { return Seat::seatTen; }
+
+  if (1 != seatStr.size() or seatStr[0] < '1' or '9' < seatStr[0]) { return {}; }
+
+  return static_cast<Seat>(seatStr[0] - '1');
+}
+
 [[nodiscard]] static constexpr int size_tToInt(std::size_t value) {
   constexpr int kIntMax { std::numeric_limits<int>::max() };
   return std::cmp_greater(value, kIntMax) ? kIntMax : static_cast<int>(value);
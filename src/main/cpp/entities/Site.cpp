@@ -13,12 +13,14 @@ import std;
 /**
  * A Poker site, i.e. a bunch of hands played on different games, that enables us to build
  * statistics on encountered players behavior.
+ * The view*() ranges and the returned strings are valid as long as the site exists and is not
+ * modified.
  */
 export class [[nodiscard]] Site final {
 private:
   std::string m_name;
   std::string m_heroName;
-  std::unordered_map<std::string, std::unique_ptr<Player>> m_players {};
+  std::map<std::string, std::unique_ptr<Player>, std::less<>> m_players {};
   std::vector<std::unique_ptr<CashGame>> m_cashGames {};
   std::vector<std::unique_ptr<Tournament>> m_tournaments {};
 
@@ -31,14 +33,57 @@ public:
   ~Site() = default; // needed because Site owns std::unique_ptr members
   void addPlayer(std::unique_ptr<Player> p);
   void addGame(std::unique_ptr<CashGame> game);
-  [[nodiscard]] std::vector<const CashGame*> viewCashGames() const;
+
+  /**
+   * @returns a random access range of const CashGame*.
+   */
+  [[nodiscard]] auto viewCashGames() const noexcept {
+    return m_cashGames | std::views::transform([](const auto & pGame) -> const CashGame* { return pGame.get(); });
+  }
+
   void addGame(std::unique_ptr<Tournament> game);
-  [[nodiscard]] std::vector<const Tournament*> viewTournaments() const;
-  [[nodiscard]] /*constexpr*/ std::string getName() const noexcept;
-  [[nodiscard]] std::vector<const Player*> viewPlayers() const;
+
+  /**
+   * @returns a random access range of const Tournament*.
+   */
+  [[nodiscard]] auto viewTournaments() const noexcept {
+    return m_tournaments | std::views::transform([](const auto & pGame) -> const Tournament* { return pGame.get(); });
+  }
+
+  [[nodiscard]] std::string_view getName() const noexcept { return m_name; }
+
+  /**
+   * @returns a sized range of const Player*, sorted by name.
+   */
+  [[nodiscard]] auto viewPlayers() const noexcept {
+    return m_players | std::views::transform([](const auto & entry) -> const Player* { return entry.second.get(); });
+  }
+
   [[nodiscard]] const Player* viewPlayer(std::string_view name) const;
   void merge(Site& other);
-  [[nodiscard]] std::string whoIsHero() const noexcept;
+
+  /**
+   * Same as merge, but the hands of a game of other that this site already has are added to the
+   * existing game instead of creating a second game, the hands it already has being dropped.
+   * @returns the number of hands dropped
+   */
+  std::size_t mergeHands(Site& other);
+
+  /**
+   * Removes the hands for which isRemoved(const Hand&) is true, then the games left without hands.
+   * @returns the number of hands removed
+   */
+  std::size_t removeHandsIf(auto&& isRemoved) {
+    std::size_t ret { 0 };
+    const auto removeFrom { [&](auto & games) {
+      std::ranges::for_each(games, [&](auto & pGame) { ret += pGame->removeHandsIf(isRemoved); });
+      std::erase_if(games, [](const auto & pGame) { return 0 == pGame->getNbHands(); });
+    } };
+    removeFrom(m_cashGames);
+    removeFrom(m_tournaments);
+    return ret;
+  }
+  [[nodiscard]] std::string_view whoIsHero() const noexcept { return m_heroName; }
 }; // class Site
 
 module : private;
@@ -51,7 +96,8 @@ void Site::addPlayer(std::unique_ptr<Player> p) {
   if (!m_players.contains(p->getName())) {
     if (p->isHero()) { m_heroName = p->getName(); }
 
-    m_players[p->getName()] = std::move(p);
+    std::string name { p->getName() };
+    m_players.emplace(std::move(name), std::move(p));
   }
 }
 
@@ -60,39 +106,13 @@ void Site::addGame(std::unique_ptr<CashGame> game) {
   m_cashGames.push_back(std::move(game));
 }
 
-template<template<typename, typename> typename SmartPointer, typename T, typename U>
-[[nodiscard]] inline std::vector<const T*> mkView(const std::vector<SmartPointer<T, U>>& v) {
-  std::vector<const T*> ret;
-  ret.reserve(v.size());
-
-  // here we use a 'for' loop to avoid depending on <algorithm>
-  for (const auto& e : v) { ret.push_back(e.get()); }
-
-  return ret;
-}
-
-
-[[nodiscard]] std::vector<const CashGame*> Site::viewCashGames() const { return mkView(m_cashGames); }
-
 void Site::addGame(std::unique_ptr<Tournament> game) {
   assert(game->getSiteName() == m_name and "game is on another site");
   m_tournaments.push_back(std::move(game));
 }
 
-[[nodiscard]] std::vector<const Tournament*> Site::viewTournaments() const { return mkView(m_tournaments); }
-
-[[nodiscard]] /*constexpr*/ std::string Site::getName() const noexcept { return m_name; }
-
-[[nodiscard]] std::vector<const Player*> Site::viewPlayers() const {
-  std::vector<const Player*> ret;
-  ret.reserve(m_players.size());
-  std::ranges::transform(m_players, std::back_inserter(ret),
-  [](const auto & entry) noexcept { return entry.second.get(); });
-  return ret;
-}
-
 [[nodiscard]] const Player* Site::viewPlayer(std::string_view name) const {
-  const auto& p { m_players.find(std::string(name)) };
+  const auto& p { m_players.find(name) };
   return m_players.end() == p ? nullptr : p->second.get();
 }
 
@@ -103,4 +123,23 @@ void Site::merge(Site& other) {
   language::containers::moveInto(other.m_tournaments, m_tournaments);
 }
 
-[[nodiscard]] std::string Site::whoIsHero() const noexcept { return m_heroName; }
+template<typename GAME_TYPE>
+static std::size_t mergeGameHands(std::vector<std::unique_ptr<GAME_TYPE>>& games,
+                                  std::vector<std::unique_ptr<GAME_TYPE>>& otherGames) {
+  std::size_t ret { 0 };
+  std::ranges::for_each(otherGames, [&games, &ret](auto & pOtherGame) {
+    const auto it { std::ranges::find_if(games, [&pOtherGame](const auto & pGame) { return pGame->getId() == pOtherGame->getId(); }) };
+
+    if (games.end() == it) { games.push_back(std::move(pOtherGame)); }
+    else { ret += pOtherGame->moveHandsInto(**it); }
+  });
+  otherGames.clear();
+  return ret;
+}
+
+std::size_t Site::mergeHands(Site& other) {
+  assert(other.getName() == m_name and "Can't merge data from different poker sites");
+  std::ranges::for_each(other.m_players, [this](auto & pair) { addPlayer(std::move(pair.second)); });
+  return mergeGameHands(m_cashGames, other.m_cashGames) + mergeGameHands(m_tournaments, other.m_tournaments);
+}
+
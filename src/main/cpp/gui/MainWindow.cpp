@@ -34,13 +34,13 @@ export module gui.MainWindow;
 
 import entities.Card;
 import entities.Game; // CashGame, Tournament
+import entities.Hand;
 import entities.Site;
 import gui.dimensions; // button size
 import gui.GameList;
 import gui.Labels;
 import gui.Preferences;
 import gui.ReviewerWindow;
-import history.WinamaxGameHistory;
 import history.WinamaxHistory;
 
 import std;
@@ -48,6 +48,7 @@ import std;
 export class [[nodiscard]] MainWindow final {
 private:
   Preferences m_preferences = Preferences();
+  WinamaxHistory m_history {}; // reads the history files through its cache
   std::unique_ptr<Fl_Double_Window> m_mainWindow = nullptr;
   std::unique_ptr<ReviewerWindow> m_reviewerWindow = nullptr;
   std::unique_ptr<GameList> m_games = nullptr;
@@ -92,15 +93,15 @@ static constexpr std::string_view CLOSE_THE_REVIEW_LABEL { "Close the review" };
 void MainWindow::newGameWindow() {
   const auto oHistoryFile { m_games->getSelectedGameHistoryFile() };
   assert(oHistoryFile.has_value());
-  const auto site { WinamaxGameHistory::parseGameHistory(oHistoryFile.value()) };
-  const auto cashGames { site->viewCashGames() };
+  const auto site { m_history.loadFile(oHistoryFile.value()) };
 
-  if (cashGames.empty()) {
+  if (nullptr == site or site->viewCashGames().empty()) {
     fl_alert("Pas de cashgame détecté dans cet historique");
     pReviewerButton->label(labels::OPEN_THE_REVIEW_LABEL.data());
     return;
   }
 
+  const auto cashGames { site->viewCashGames() };
   assert(1 == cashGames.size());
   const auto [localX, localY, width, height] { m_preferences.getGameWindowXYWH() };
 
@@ -110,11 +111,12 @@ void MainWindow::newGameWindow() {
     // tell the user the review button will open a new game window
     pReviewerButton->label(labels::OPEN_THE_REVIEW_LABEL.data());
     };
+  const auto hands { cashGames[0]->viewHands() };
   m_reviewerWindow = std::make_unique<ReviewerWindow>(m_preferences,
     cashGames[0]->getId(),
     deleteReviewerWindow,
     site->whoIsHero(),
-    cashGames[0]->viewHands());
+    std::vector<const Hand*>(hands.begin(), hands.end()));
 }
 
 /**
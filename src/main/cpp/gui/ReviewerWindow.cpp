@@ -38,6 +38,7 @@ import gui.dimensions; // button size
 import gui.Labels;
 import gui.Preferences;
 import language.Map;
+import system.StringPool;
 
 #pragma warning( push )
 #pragma warning( disable : 4686)
@@ -172,11 +173,9 @@ static void drawCards(int w, int h, const Hand& hand, std::string_view hero) {
          Seat::seatSeven,
          Seat::seatEight, Seat::seatNine, Seat::seatTen
   };
-  const auto& seatPlayers { hand.getSeats() };
-
   std::ranges::for_each(seats, [&](const auto seat) {
-    if (const auto& entry { seatPlayers.find(seat) }; entry != seatPlayers.end()) {
-      const auto& player { entry->second };
+    if (const auto playerId { hand.getPlayer(seat) }; PlayerId::none != playerId) {
+      const auto player { stringPool::view(playerId) };
       const auto [card1, card2] { getCards(player, hand, hero) };
       auto box1 { toCardBox(card1) };
       auto box2 { toCardBox(card2) };
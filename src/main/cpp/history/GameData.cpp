@@ -4,6 +4,7 @@ export module history.GameData;
 
 import entities.Game; // Time, Variant, Limit
 import entities.Seat;
+import system.Money;
 import system.Time;
 
 import std;
@@ -13,18 +14,18 @@ export struct [[nodiscard]] GameData final {
   bool m_isRealMoney { false };
   Variant m_variant { Variant::none };
   Limit m_limit { Limit::none };
-  double m_smallBlind { 0 };
-  double m_bigBlind { 0 };
-  double m_buyIn { 0 };
+  Money m_smallBlind {};
+  Money m_bigBlind {};
+  Money m_buyIn {};
   std::string m_tableName {};
   std::string m_gameName {};
   Time m_startDate;
 
   struct [[nodiscard]] Args final {
     Seat nbMaxSeats;
-    double smallBlind;
-    double bigBlind;
-    double buyIn;
+    Money smallBlind;
+    Money bigBlind;
+    Money buyIn;
     const Time& startDate;
   };
 
@@ -0,0 +1,387 @@
+module;
+
+#include <cassert> // assert
+
+export module history.HandStore;
+
+import entities.Action;
+import entities.Card;
+import entities.Game; // CashGame, Tournament
+import entities.GameType;
+import entities.Hand;
+import entities.HandId;
+import entities.Seat;
+import entities.Site;
+import system.MappedFile;
+import system.Money;
+import system.StringPool;
+import system.Time;
+
+#pragma warning( push )
+#pragma warning( disable : 4686)
+import std;
+#pragma warning( pop )
+
+/**
+ * A string of the strings column of a hand store.
+ */
+export struct [[nodiscard]] StoredString final {
+  std::uint32_t offset { 0 };
+  std::uint32_t size { 0 };
+};
+
+/**
+ * The stakes of a hand: the blinds for a cash game, the buy-in and level for a tournament.
+ */
+export struct [[nodiscard]] StoredStakes final {
+  Money smallBlind {};
+  Money bigBlind {};
+  Money buyIn {};
+  std::int64_t ante { 0 };
+  std::int32_t level { 0 };
+  GameType gameType { GameType::none };
+  std::int16_t reserved { 0 }; // written as zero, instead of padding bytes of any value
+};
+
+export struct [[nodiscard]] StoredAction final {
+  Money betAmount {};
+  StoredString playerName {};
+  std::uint32_t index { 0 };
+  Street street { Street::none };
+  ActionType type { ActionType::none };
+};
+
+// the player names by seat, see tableSeat::toArrayIndex(). An empty seat has an empty name.
+export using StoredSeats = std::array<StoredString, 10>;
+export using StoredCards = std::array<Card, 5>;
+
+export namespace handStore {
+/**
+ * Writes the hands of site in the given hand store file (usually with the .prmh extension),
+ * replacing it.
+ * @throws std::runtime_error if the file can't be written
+ */
+void write(const Site& site, const std::filesystem::path& file);
+void write(const Site&, auto) = delete; // use only std::filesystem::path
+} // namespace handStore
+
+/**
+ * A read-only view on a hand store file written by handStore::write().
+ * A hand store keeps one column per hand attribute, hand i being at index i in each column. The
+ * file is memory mapped and the columns are used in place, so opening a hand store parses nothing
+ * and scanning a column is a sequential read.
+ */
+export class [[nodiscard]] HandStore final {
+private:
+  MappedFile m_file;
+  std::span<const HandId> m_handIds {};
+  std::span<const std::int64_t> m_startDates {};
+  std::span<const StoredString> m_tableNames {};
+  std::span<const StoredStakes> m_stakes {};
+  std::span<const Seat> m_buttonSeats {};
+  std::span<const StoredSeats> m_seats {};
+  std::span<const StoredCards> m_heroCards {};
+  std::span<const StoredCards> m_boardCards {};
+  std::span<const std::uint16_t> m_winners {};
+  std::span<const std::uint64_t> m_actionOffsets {};
+  std::span<const StoredAction> m_actions {};
+  std::string_view m_strings {};
+
+  void validate() const;
+
+public:
+  /**
+   * @throws std::runtime_error if the file is not a valid hand store: every column, string and
+   * action range must lie in the file, and every enum value must be in range
+   */
+  explicit HandStore(const std::filesystem::path& file);
+  HandStore(auto) = delete; // use only std::filesystem::path
+  HandStore(const HandStore&) = delete;
+  HandStore(HandStore&&) = delete;
+  HandStore& operator=(const HandStore&) = delete;
+  HandStore& operator=(HandStore&&) = delete;
+  ~HandStore() = default;
+
+  [[nodiscard]] std::size_t getNbHands() const noexcept { return m_handIds.size(); }
+  [[nodiscard]] std::span<const HandId> getHandIds() const noexcept { return m_handIds; }
+
+  // in seconds since the epoch
+  [[nodiscard]] std::span<const std::int64_t> getStartDates() const noexcept { return m_startDates; }
+  [[nodiscard]] std::span<const StoredString> getTableNames() const noexcept { return m_tableNames; }
+  [[nodiscard]] std::span<const StoredStakes> getStakes() const noexcept { return m_stakes; }
+  [[nodiscard]] std::span<const Seat> getButtonSeats() const noexcept { return m_buttonSeats; }
+  [[nodiscard]] std::span<const StoredSeats> getSeats() const noexcept { return m_seats; }
+  [[nodiscard]] std::span<const StoredCards> getHeroCards() const noexcept { return m_heroCards; }
+  [[nodiscard]] std::span<const StoredCards> getBoardCards() const noexcept { return m_boardCards; }
+
+  // the seats of the winners, the bit i being set if the player at tableSeat::fromArrayIndex(i) won
+  [[nodiscard]] std::span<const std::uint16_t> getWinners() const noexcept { return m_winners; }
+
+  // the actions of every hand, in hand order
+  [[nodiscard]] std::span<const StoredAction> getActions() const noexcept { return m_actions; }
+  // handIndex < getNbHands()
+  [[nodiscard]] std::span<const StoredAction> getActions(std::size_t handIndex) const;
+
+  /**
+   * @returns the stored string, valid as long as the HandStore object lives.
+   * @throws std::out_of_range if s is not a string of this hand store
+   */
+  [[nodiscard]] std::string_view toString(StoredString s) const;
+}; // class HandStore
+
+module : private;
+
+static constexpr std::uint32_t MAGIC { 0x484d5250 }; // "PRMH"
+static constexpr std::uint32_t VERSION { 4 };
+static constexpr std::size_t COLUMN_ALIGNMENT { 8 };
+
+enum class Column : std::size_t {
+  handIds, startDates, tableNames, stakes, buttonSeats, seats, heroCards, boardCards, winners,
+  actionOffsets, actions, strings, nbColumns
+};
+
+struct [[nodiscard]] ColumnLocation final {
+  std::uint64_t offset { 0 };
+  std::uint64_t size { 0 }; // in bytes
+};
+
+struct [[nodiscard]] FileHeader final {
+  std::uint32_t magic { MAGIC };
+  std::uint32_t version { VERSION };
+  std::uint64_t nbHands { 0 };
+  std::array<ColumnLocation, std::to_underlying(Column::nbColumns)> columns {};
+};
+
+// the strings are stored once, whatever the number of hands using them
+class [[nodiscard]] StringsColumn final {
+private:
+  std::string m_chars {};
+  std::unordered_map<std::string, StoredString> m_stored {};
+
+public:
+  [[nodiscard]] StoredString add(std::string_view s) {
+    if (s.empty()) { return {}; }
+
+    auto [it, isNew] { m_stored.try_emplace(std::string(s)) };
+
+    if (isNew) {
+      if (std::numeric_limits<std::uint32_t>::max() - m_chars.size() < s.size()) {
+        m_stored.erase(it);
+        throw std::runtime_error("Too many strings for a hand store");
+      }
+
+      it->second = { .offset = static_cast<std::uint32_t>(m_chars.size()), .size = static_cast<std::uint32_t>(s.size()) };
+      m_chars.append(s);
+    }
+
+    return it->second;
+  }
+
+  [[nodiscard]] std::span<const char> getChars() const noexcept { return m_chars; }
+}; // class StringsColumn
+
+struct [[nodiscard]] Columns final {
+  std::vector<HandId> handIds {};
+  std::vector<std::int64_t> startDates {};
+  std::vector<StoredString> tableNames {};
+  std::vector<StoredStakes> stakes {};
+  std::vector<Seat> buttonSeats {};
+  std::vector<StoredSeats> seats {};
+  std::vector<StoredCards> heroCards {};
+  std::vector<StoredCards> boardCards {};
+  std::vector<std::uint16_t> winners {};
+  std::vector<std::uint64_t> actionOffsets { 0 };
+  std::vector<StoredAction> actions {};
+  StringsColumn strings {};
+
+  void add(const Hand& hand, StoredStakes stakes);
+}; // struct Columns
+
+void Columns::add(const Hand& hand, StoredStakes handStakes) {
+  handIds.push_back(hand.getId());
+  startDates.push_back(hand.getStartDate().toSysSeconds().time_since_epoch().count());
+  tableNames.push_back(strings.add(hand.getTableName()));
+  handStakes.ante = hand.getAnte();
+  handStakes.level = hand.getLevel();
+  handStakes.gameType = hand.getGameType();
+  stakes.push_back(handStakes);
+  buttonSeats.push_back(hand.getButtonSeat());
+  StoredSeats handSeats {};
+  std::uint16_t handWinners { 0 };
+  std::ranges::transform(hand.getSeats(), handSeats.begin(), [this](PlayerId playerId) {
+    return strings.add(stringPool::view(playerId));
+  });
+  seats.push_back(handSeats);
+  winners.push_back(hand.getWinnerSeats());
+  heroCards.push_back({ hand.getHeroCard1(), hand.getHeroCard2(), hand.getHeroCard3(), hand.getHeroCard4(), hand.getHeroCard5() });
+  boardCards.push_back({ hand.getBoardCard1(), hand.getBoardCard2(), hand.getBoardCard3(), hand.getBoardCard4(), hand.getBoardCard5() });
+  std::ranges::transform(hand.viewActions(), std::back_inserter(actions), [this](const Action & action) {
+    return StoredAction { .betAmount = action.getBetAmount(), .playerName = strings.add(action.getPlayerName()),
+                          .index = static_cast<std::uint32_t>(action.getIndex()), .street = action.getStreet(),
+                          .type = action.getType() };
+  });
+  actionOffsets.push_back(actions.size());
+}
+
+// a type without padding has every byte of its values set, so that the file gets no uninitialized byte
+template<typename T>
+constexpr bool IS_STORABLE { std::is_trivially_copyable_v<T> and std::has_unique_object_representations_v<T>
+                             and 0 == COLUMN_ALIGNMENT % alignof(T) };
+
+template<typename T>
+static void appendColumn(std::string& bytes, FileHeader& header, Column column, std::span<const T> values) {
+  static_assert(IS_STORABLE<T>);
+  bytes.resize((bytes.size() + COLUMN_ALIGNMENT - 1) / COLUMN_ALIGNMENT * COLUMN_ALIGNMENT, '\0');
+  header.columns.at(std::to_underlying(column)) = { .offset = bytes.size(), .size = values.size_bytes() };
+  bytes.append(reinterpret_cast<const char*>(values.data()), values.size_bytes());
+}
+
+[[nodiscard]] static std::string toBytes(const Columns& c) {
+  static_assert(IS_STORABLE<FileHeader>);
+  FileHeader header { .nbHands = c.handIds.size() };
+  std::string ret(sizeof(FileHeader), '\0');
+  appendColumn<HandId>(ret, header, Column::handIds, c.handIds);
+  appendColumn<std::int64_t>(ret, header, Column::startDates, c.startDates);
+  appendColumn<StoredString>(ret, header, Column::tableNames, c.tableNames);
+  appendColumn<StoredStakes>(ret, header, Column::stakes, c.stakes);
+  appendColumn<Seat>(ret, header, Column::buttonSeats, c.buttonSeats);
+  appendColumn<StoredSeats>(ret, header, Column::seats, c.seats);
+  appendColumn<StoredCards>(ret, header, Column::heroCards, c.heroCards);
+  appendColumn<StoredCards>(ret, header, Column::boardCards, c.boardCards);
+  appendColumn<std::uint16_t>(ret, header, Column::winners, c.winners);
+  appendColumn<std::uint64_t>(ret, header, Column::actionOffsets, c.actionOffsets);
+  appendColumn<StoredAction>(ret, header, Column::actions, c.actions);
+  appendColumn<char>(ret, header, Column::strings, c.strings.getChars());
+  std::memcpy(ret.data(), &header, sizeof(FileHeader));
+  return ret;
+}
+
+void handStore::write(const Site& site, const std::filesystem::path& file) {
+  Columns columns;
+  std::ranges::for_each(site.viewCashGames(), [&columns](const CashGame * pGame) {
+    const StoredStakes stakes { .smallBlind = pGame->getSmallBlind(), .bigBlind = pGame->getBigBlind() };
+    std::ranges::for_each(pGame->viewHands(), [&](const Hand * pHand) { columns.add(*pHand, stakes); });
+  });
+  std::ranges::for_each(site.viewTournaments(), [&columns](const Tournament * pGame) {
+    const StoredStakes stakes { .buyIn = pGame->getBuyIn() };
+    std::ranges::for_each(pGame->viewHands(), [&](const Hand * pHand) { columns.add(*pHand, stakes); });
+  });
+  const auto& bytes { toBytes(columns) };
+  // write then rename, so that a reader never maps a partially written file
+  auto tmpFile { file };
+  tmpFile += ".tmp";
+  {
+    std::ofstream out { tmpFile, std::ios::binary | std::ios::trunc };
+    out.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+
+    if (!out) { throw std::runtime_error(std::format("Can't write the hand store {}", file.string())); }
+  }
+  std::filesystem::rename(tmpFile, file);
+}
+
+[[noreturn]] static void throwInvalid(std::string_view what) {
+  throw std::runtime_error(std::format("Invalid hand store {}", what));
+}
+
+// the column must lie in the file and hold expectedSize values, the sizes read from the file being
+// compared by divisions so that no product overflows
+template<typename T>
+[[nodiscard]] static std::span<const T> toColumn(std::string_view bytes, const FileHeader& header,
+    Column column, std::uint64_t expectedSize) {
+  const auto& [offset, size] { header.columns.at(std::to_underlying(column)) };
+
+  if (sizeof(FileHeader) > offset or bytes.size() < offset or bytes.size() - offset < size
+      or 0 != offset % alignof(T) or 0 != size % sizeof(T) or expectedSize != size / sizeof(T)) {
+    throwInvalid(std::format("column {}", std::to_underlying(column)));
+  }
+
+  // the mapping is page aligned and the column offset is aligned for T
+  return { reinterpret_cast<const T*>(bytes.data() + offset), static_cast<std::size_t>(expectedSize) };
+}
+
+template<typename E>
+[[nodiscard]] static bool isInRange(E value, E last) noexcept {
+  return 0 <= std::to_underlying(value) and std::to_underlying(value) <= std::to_underlying(last);
+}
+
+[[nodiscard]] static bool areValidCards(const StoredCards& cards) noexcept {
+  return std::ranges::all_of(cards, [](Card c) { return isInRange(c, Card::back); });
+}
+
+// the values used as indexes, the action ranges and the string locations are checked once, here,
+// so that the getters can use them without any check
+void HandStore::validate() const {
+  const auto isValidString { [this](StoredString s) {
+    return s.offset <= m_strings.size() and s.size <= m_strings.size() - s.offset;
+  } };
+
+  if (!std::ranges::all_of(m_tableNames, isValidString)
+      or !std::ranges::all_of(m_seats, [&](const StoredSeats & seats) { return std::ranges::all_of(seats, isValidString); })
+      or !std::ranges::all_of(m_actions, [&](const StoredAction & a) { return isValidString(a.playerName); })) {
+    throwInvalid("string");
+  }
+
+  if (0 != m_actionOffsets.front() or m_actions.size() != m_actionOffsets.back()
+      or !std::ranges::is_sorted(m_actionOffsets)) {
+    throwInvalid("action offsets");
+  }
+
+  if (!std::ranges::all_of(m_stakes, [](const StoredStakes & s) { return isInRange(s.gameType, GameType::tournament); })
+      or !std::ranges::all_of(m_buttonSeats, [](Seat s) { return isInRange(s, Seat::seatUnknown); })
+      or !std::ranges::all_of(m_winners, [](std::uint16_t w) { return w < (1U << std::tuple_size_v<StoredSeats>); })
+      or !std::ranges::all_of(m_heroCards, areValidCards) or !std::ranges::all_of(m_boardCards, areValidCards)
+      or !std::ranges::all_of(m_actions, [](const StoredAction & a) {
+        return isInRange(a.street, Street::river) and isInRange(a.type, ActionType::raise);
+      })) {
+    throwInvalid("value");
+  }
+}
+
+HandStore::HandStore(const std::filesystem::path& file) : m_file { file } {
+  const auto bytes { m_file.view() };
+
+  if (sizeof(FileHeader) > bytes.size()) { throw std::runtime_error(std::format("{} is not a hand store", file.string())); }
+
+  FileHeader header;
+  std::memcpy(&header, bytes.data(), sizeof(FileHeader));
+
+  if (MAGIC != header.magic or VERSION != header.version) {
+    throw std::runtime_error(std::format("{} is not a version {} hand store", file.string(), VERSION));
+  }
+
+  // each hand takes more than one byte, which bounds nbHands + 1 below any overflow
+  if (bytes.size() < header.nbHands) { throwInvalid("number of hands"); }
+
+  const auto nbHands { header.nbHands };
+  m_handIds = toColumn<HandId>(bytes, header, Column::handIds, nbHands);
+  m_startDates = toColumn<std::int64_t>(bytes, header, Column::startDates, nbHands);
+  m_tableNames = toColumn<StoredString>(bytes, header, Column::tableNames, nbHands);
+  m_stakes = toColumn<StoredStakes>(bytes, header, Column::stakes, nbHands);
+  m_buttonSeats = toColumn<Seat>(bytes, header, Column::buttonSeats, nbHands);
+  m_seats = toColumn<StoredSeats>(bytes, header, Column::seats, nbHands);
+  m_heroCards = toColumn<StoredCards>(bytes, header, Column::heroCards, nbHands);
+  m_boardCards = toColumn<StoredCards>(bytes, header, Column::boardCards, nbHands);
+  m_winners = toColumn<std::uint16_t>(bytes, header, Column::winners, nbHands);
+  m_actionOffsets = toColumn<std::uint64_t>(bytes, header, Column::actionOffsets, nbHands + 1);
+  const auto actionsSize { header.columns.at(std::to_underlying(Column::actions)).size };
+  m_actions = toColumn<StoredAction>(bytes, header, Column::actions, actionsSize / sizeof(StoredAction));
+  const auto stringsSize { header.columns.at(std::to_underlying(Column::strings)).size };
+  const auto strings { toColumn<char>(bytes, header, Column::strings, stringsSize) };
+  m_strings = { strings.data(), strings.size() };
+  validate();
+}
+
+std::span<const StoredAction> HandStore::getActions(std::size_t handIndex) const {
+  const auto first { m_actionOffsets[handIndex] };
+  const auto last { m_actionOffsets[handIndex + 1] };
+  assert(first <= last and last <= m_actions.size() and "action offsets checked on load");
+  return m_actions.subspan(first, last - first);
+}
+
+std::string_view HandStore::toString(StoredString s) const {
+  if (s.offset > m_strings.size() or s.size > m_strings.size() - s.offset) {
+    throw std::out_of_range("Not a string of the hand store");
+  }
+
+  return m_strings.substr(s.offset, s.size);
+}
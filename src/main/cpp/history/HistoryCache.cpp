@@ -0,0 +1,425 @@
+module;
+
+export module history.HistoryCache;
+
+import entities.Action;
+import entities.Card;
+import entities.Game; // CashGame, Tournament, Variant, Limit
+import entities.GameType;
+import entities.Hand;
+import entities.HandId;
+import entities.Player;
+import entities.Seat;
+import entities.Site;
+import system.Blob;
+import system.MappedFile;
+import system.MemoryArena;
+import system.Money;
+import system.StringPool;
+import system.Time;
+
+#pragma warning( push )
+#pragma warning( disable : 4686)
+import std;
+#pragma warning( pop )
+
+/**
+ * An on-disk cache of the parsed content of history files.
+ * Each history file has its own cache file, which is used only if the history file size, last
+ * modification time and content fingerprint are the ones recorded when the cache file was written.
+ * The methods can be called concurrently for different history files.
+ */
+export class [[nodiscard]] HistoryCache final {
+private:
+  std::filesystem::path m_dir;
+
+public:
+  /**
+   * @param cacheDir where the cache files are written. An empty path disables the cache.
+   */
+  explicit HistoryCache(const std::filesystem::path& cacheDir);
+  HistoryCache(auto) = delete; // use only std::filesystem::path
+
+  /**
+   * @returns the cached content of the given history file, or nullptr if the cache is missing or
+   * out of date.
+   */
+  [[nodiscard]] std::unique_ptr<Site> load(const std::filesystem::path& historyFile) const;
+  std::unique_ptr<Site> load(auto) const = delete;
+
+  /**
+   * Caches site as the parsed content of the given history file. Failures are silently ignored.
+   */
+  void store(const std::filesystem::path& historyFile, const Site& site) const;
+  void store(auto, const Site&) const = delete;
+}; // class HistoryCache
+
+module : private;
+
+static constexpr std::uint32_t MAGIC { 0x434d5250 }; // "PRMC"
+static constexpr std::uint32_t VERSION { 6 };
+
+// a fast, non cryptographic, hash of 8 bytes words
+[[nodiscard]] static constexpr std::uint64_t mix(std::uint64_t hash, std::uint64_t word) noexcept {
+  hash ^= word * 0x9e3779b97f4a7c15ULL;
+  hash = std::rotl(hash, 31) * 0xbf58476d1ce4e5b9ULL;
+  return hash ^ (hash >> 29);
+}
+
+[[nodiscard]] static std::uint64_t hashBytes(std::string_view bytes, std::uint64_t hash = 0) noexcept {
+  std::size_t i { 0 };
+
+  for (; i + 8 <= bytes.size(); i += 8) {
+    std::uint64_t word;
+    std::memcpy(&word, bytes.data() + i, 8);
+    hash = mix(hash, word);
+  }
+
+  for (; i < bytes.size(); ++i) { hash = mix(hash, static_cast<unsigned char>(bytes[i])); }
+
+  return mix(hash, bytes.size());
+}
+
+// the whole content is hashed, as an edit keeping the size and the modification time may be
+// anywhere in the file
+[[nodiscard]] static std::optional<std::uint64_t> fingerprint(const std::filesystem::path& historyFile,
+    std::uintmax_t fileSize) {
+  if (0 == fileSize) { return hashBytes({}); }
+
+  const MappedFile mapping { historyFile };
+
+  if (!mapping.isMapped() or fileSize != mapping.size()) { return {}; }
+
+  return hashBytes(mapping.view());
+}
+
+struct [[nodiscard]] FileStamp final {
+  std::uint64_t size { 0 };
+  std::int64_t lastWriteTime { 0 };
+  std::uint64_t fingerprint { 0 };
+
+  [[nodiscard]] bool operator==(const FileStamp&) const noexcept = default;
+}; // struct FileStamp
+
+[[nodiscard]] static std::optional<FileStamp> toFileStamp(const std::filesystem::path& historyFile) {
+  std::error_code ec;
+  const auto size { std::filesystem::file_size(historyFile, ec) };
+
+  if (ec) { return {}; }
+
+  const auto lastWriteTime { std::filesystem::last_write_time(historyFile, ec) };
+
+  if (ec) { return {}; }
+
+  const auto oFingerprint { fingerprint(historyFile, size) };
+
+  if (!oFingerprint.has_value()) { return {}; }
+
+  return FileStamp { .size = size, .lastWriteTime = lastWriteTime.time_since_epoch().count(),
+                     .fingerprint = oFingerprint.value() };
+}
+
+[[nodiscard]] static std::filesystem::path toCacheFile(const std::filesystem::path& cacheDir,
+    const std::filesystem::path& historyFile) {
+  const auto& key { historyFile.lexically_normal().string() };
+  return cacheDir / std::format("{:016x}.prmc", hashBytes(key));
+}
+
+static void writeTime(BlobWriter& w, const Time& t) {
+  w.write(static_cast<std::int64_t>(t.toSysSeconds().time_since_epoch().count()));
+}
+
+[[nodiscard]] static Time readTime(BlobReader& r) {
+  return Time { std::chrono::sys_seconds { std::chrono::seconds { r.read<std::int64_t>() } } };
+}
+
+// a value that the entities would reject means a corrupted cache file, which is a cache miss just
+// as a truncated one
+static void checkValue(bool isValid) {
+  if (!isValid) { throw std::out_of_range("corrupted cache file"); }
+}
+
+template<typename E>
+[[nodiscard]] static E readEnum(BlobReader& r, E first, E last) {
+  const auto value { r.read<std::underlying_type_t<E>>() };
+  checkValue(std::to_underlying(first) <= value and value <= std::to_underlying(last));
+  return static_cast<E>(value);
+}
+
+[[nodiscard]] static bool readBool(BlobReader& r) {
+  const auto value { r.read<std::uint8_t>() };
+  checkValue(1 >= value);
+  return 1 == value;
+}
+
+[[nodiscard]] static std::string_view readNonEmptyString(BlobReader& r) {
+  const auto ret { r.readString() };
+  checkValue(!ret.empty());
+  return ret;
+}
+
+[[nodiscard]] static Money readNonNegativeMoney(BlobReader& r) {
+  const auto ret { r.read<Money>() };
+  checkValue(Money {} <= ret);
+  return ret;
+}
+
+[[nodiscard]] static std::array<Card, 5> readCards(BlobReader& r) {
+  std::array<Card, 5> ret {};
+  std::ranges::for_each(ret, [&r](auto & card) { card = readEnum(r, Card::none, Card::back); });
+  return ret;
+}
+
+static void writeHand(BlobWriter& w, const Hand& hand) {
+  w.write(hand.getId());
+  w.write(hand.getGameType());
+  w.writeString(hand.getTableName());
+  w.write(hand.getButtonSeat());
+  w.write(hand.getMaxSeats());
+  w.write(hand.getLevel());
+  w.write(static_cast<std::int64_t>(hand.getAnte())); // long has 4 bytes on Windows, 8 on Linux
+  writeTime(w, hand.getStartDate());
+  w.write(std::array { hand.getHeroCard1(), hand.getHeroCard2(), hand.getHeroCard3(), hand.getHeroCard4(), hand.getHeroCard5() });
+  w.write(std::array { hand.getBoardCard1(), hand.getBoardCard2(), hand.getBoardCard3(), hand.getBoardCard4(), hand.getBoardCard5() });
+  std::ranges::for_each(hand.getSeats(), [&w](PlayerId player) { w.writeString(stringPool::view(player)); });
+  const auto actions { hand.viewActions() };
+  w.write(static_cast<std::uint32_t>(actions.size()));
+  std::ranges::for_each(actions, [&w](const Action & action) {
+    w.writeString(action.getPlayerName());
+    w.write(action.getStreet());
+    w.write(action.getType());
+    w.write(action.getIndex());
+    w.write(action.getBetAmount());
+  });
+  w.write(hand.getWinnerSeats());
+}
+
+// actions is a buffer reused from one hand to the next
+[[nodiscard]] static ArenaPtr<Hand> readHand(BlobReader& r, std::string_view siteName, MemoryArena& arena,
+    std::vector<Action>& actions) {
+  const auto handId { r.read<HandId>() };
+  const auto gameType { readEnum(r, GameType::none, GameType::tournament) };
+  const auto tableName { readNonEmptyString(r) };
+  const auto buttonSeat { readEnum(r, Seat::seatOne, Seat::seatUnknown) };
+  const auto maxSeats { readEnum(r, Seat::seatOne, Seat::seatUnknown) };
+  const auto level { r.read<int>() };
+  const auto ante { r.read<std::int64_t>() };
+  checkValue(0 <= ante and ante <= std::numeric_limits<long>::max());
+  const auto startDate { readTime(r) };
+  const auto heroCards { readCards(r) };
+  const auto boardCards { readCards(r) };
+  std::array<PlayerId, 10> seats {};
+  std::ranges::for_each(seats, [&r](auto & player) { player = stringPool::internPlayer(r.readString()); });
+  checkValue(1 < std::ranges::count_if(seats, [](PlayerId player) { return PlayerId::none != player; }));
+
+  const auto nbActions { r.read<std::uint32_t>() };
+  actions.clear(); // not reserved, as nbActions may be corrupted
+
+  for (std::uint32_t i { 0 }; i < nbActions; ++i) {
+    const auto playerName { readNonEmptyString(r) };
+    const auto street { readEnum(r, Street::preflop, Street::river) };
+    const auto type { readEnum(r, ActionType::none, ActionType::raise) };
+    const auto index { r.read<std::size_t>() };
+    const auto betAmount { readNonNegativeMoney(r) };
+    actions.emplace_back(Action::Params { .playerId = stringPool::internPlayer(playerName), .street = street,
+                                          .type = type, .actionIndex = index, .betAmount = betAmount });
+  }
+
+  const auto winnerSeats { r.read<std::uint16_t>() };
+  checkValue(winnerSeats < (1U << seats.size()));
+  std::array<PlayerId, 10> winners {};
+
+  for (std::size_t i { 0 }; i < seats.size(); ++i) {
+    if (0 != (winnerSeats & (1U << i))) {
+      checkValue(PlayerId::none != seats[i]); // a winner is seated
+      winners[i] = seats[i];
+    }
+  }
+
+  Hand::Params params { .id = handId, .gameType = gameType, .siteName = siteName,
+                        .tableName = tableName, .buttonSeat = buttonSeat, .maxSeats = maxSeats, .level = level,
+                        .ante = static_cast<long>(ante), .startDate = startDate, .seatPlayers = seats, .heroCards = heroCards,
+                        .boardCards = boardCards, .actions = actions, .winners = winners };
+  return arena.make<Hand>(params);
+}
+
+// writes the fields common to cash games and tournaments
+static void writeGameHeader(BlobWriter& w, const Game& game) {
+  w.writeString(game.getId());
+  w.writeString(game.getName());
+  w.write(game.getVariant());
+  w.write(game.getLimitType());
+  w.write(game.isRealMoney());
+  w.write(game.getMaxNbSeats());
+  writeTime(w, game.getStartDate());
+}
+
+static void writeHands(BlobWriter& w, const Game& game) {
+  const auto& hands { game.viewHands() };
+  w.write(static_cast<std::uint32_t>(hands.size()));
+  std::ranges::for_each(hands, [&w](const Hand * pHand) { writeHand(w, *pHand); });
+}
+
+// the fields common to cash games and tournaments, in the order written by writeGameHeader()
+struct [[nodiscard]] GameHeader final {
+  std::string_view id;
+  std::string_view name;
+  Variant variant;
+  Limit limit;
+  bool isRealMoney;
+  Seat nbMaxSeats;
+  Time startDate;
+};
+
+[[nodiscard]] static GameHeader readGameHeader(BlobReader& r) {
+  const auto id { readNonEmptyString(r) };
+  const auto name { readNonEmptyString(r) };
+  const auto variant { readEnum(r, Variant::none, Variant::omaha5) };
+  const auto limit { readEnum(r, Limit::none, Limit::potLimit) };
+  const auto isRealMoney { readBool(r) };
+  const auto nbMaxSeats { readEnum(r, Seat::seatOne, Seat::seatTen) };
+  return { .id = id, .name = name, .variant = variant, .limit = limit, .isRealMoney = isRealMoney,
+           .nbMaxSeats = nbMaxSeats, .startDate = readTime(r) };
+}
+
+static void readHands(BlobReader& r, Game& game, std::string_view siteName,
+                      const std::shared_ptr<MemoryArena>& pArena) {
+  std::vector<Action> actions;
+
+  for (auto nbHands { r.read<std::uint32_t>() }; 0 < nbHands; --nbHands) {
+    game.addHand(readHand(r, siteName, *pArena, actions), pArena);
+  }
+}
+
+static void writeSite(BlobWriter& w, const Site& site) {
+  const auto& players { site.viewPlayers() };
+  w.write(static_cast<std::uint32_t>(players.size()));
+  std::ranges::for_each(players, [&w](const Player * pPlayer) {
+    w.writeString(pPlayer->getName());
+    w.writeString(pPlayer->getComments());
+    w.write(pPlayer->isHero());
+  });
+  const auto& cashGames { site.viewCashGames() };
+  w.write(static_cast<std::uint32_t>(cashGames.size()));
+  std::ranges::for_each(cashGames, [&w](const CashGame * pGame) {
+    writeGameHeader(w, *pGame);
+    w.write(pGame->getSmallBlind());
+    w.write(pGame->getBigBlind());
+    writeHands(w, *pGame);
+  });
+  const auto& tournaments { site.viewTournaments() };
+  w.write(static_cast<std::uint32_t>(tournaments.size()));
+  std::ranges::for_each(tournaments, [&w](const Tournament * pGame) {
+    writeGameHeader(w, *pGame);
+    w.write(pGame->getBuyIn());
+    writeHands(w, *pGame);
+  });
+}
+
+[[nodiscard]] static std::unique_ptr<Site> readSite(BlobReader& r, std::string_view siteName) {
+  auto ret { std::make_unique<Site>(siteName) };
+  const auto pArena { std::make_shared<MemoryArena>() }; // for the hands of all the games of the file
+
+  for (auto nbPlayers { r.read<std::uint32_t>() }; 0 < nbPlayers; --nbPlayers) {
+    const auto name { readNonEmptyString(r) };
+    const auto comments { r.readString() };
+    auto pPlayer { std::make_unique<Player>(Player::Params { .name = name, .site = siteName, .comments = comments }) };
+    pPlayer->setIsHero(readBool(r));
+    ret->addPlayer(std::move(pPlayer));
+  }
+
+  for (auto nbCashGames { r.read<std::uint32_t>() }; 0 < nbCashGames; --nbCashGames) {
+    const auto header { readGameHeader(r) };
+    const auto smallBlind { readNonNegativeMoney(r) };
+    const auto bigBlind { readNonNegativeMoney(r) };
+    auto pGame { std::make_unique<CashGame>(CashGame::Params { .id = header.id, .siteName = siteName,
+                 .cashGameName = header.name, .variant = header.variant, .limit = header.limit,
+                 .isRealMoney = header.isRealMoney, .nbMaxSeats = header.nbMaxSeats,
+                 .smallBlind = smallBlind, .bigBlind = bigBlind, .startDate = header.startDate }) };
+    readHands(r, *pGame, siteName, pArena);
+    ret->addGame(std::move(pGame));
+  }
+
+  for (auto nbTournaments { r.read<std::uint32_t>() }; 0 < nbTournaments; --nbTournaments) {
+    const auto header { readGameHeader(r) };
+    const auto buyIn { readNonNegativeMoney(r) };
+    auto pGame { std::make_unique<Tournament>(Tournament::Params { .id = header.id, .siteName = siteName,
+                 .tournamentName = header.name, .variant = header.variant, .limit = header.limit,
+                 .isRealMoney = header.isRealMoney, .nbMaxSeats = header.nbMaxSeats,
+                 .buyIn = buyIn, .startDate = header.startDate }) };
+    readHands(r, *pGame, siteName, pArena);
+    ret->addGame(std::move(pGame));
+  }
+
+  return ret;
+}
+
+HistoryCache::HistoryCache(const std::filesystem::path& cacheDir) : m_dir { cacheDir } {}
+
+std::unique_ptr<Site> HistoryCache::load(const std::filesystem::path& historyFile) const {
+  if (m_dir.empty()) { return nullptr; }
+
+  const auto oStamp { toFileStamp(historyFile) };
+
+  if (!oStamp.has_value()) { return nullptr; }
+
+  std::ifstream in { toCacheFile(m_dir, historyFile), std::ios::binary };
+
+  if (!in) { return nullptr; }
+
+  const std::string bytes { std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>() };
+
+  try {
+    BlobReader r { bytes };
+
+    if (MAGIC != r.read<std::uint32_t>() or VERSION != r.read<std::uint32_t>()
+        or historyFile.lexically_normal().string() != r.readString()
+        or oStamp.value() != r.read<FileStamp>()) {
+      return nullptr;
+    }
+
+    const std::string siteName { readNonEmptyString(r) };
+    auto ret { readSite(r, siteName) };
+
+    if (!r.isAtEnd()) { return nullptr; }
+
+    return ret;
+  } catch (const std::out_of_range&) {
+    return nullptr; // a truncated or corrupted cache file is a cache miss
+  }
+}
+
+void HistoryCache::store(const std::filesystem::path& historyFile, const Site& site) const {
+  if (m_dir.empty()) { return; }
+
+  const auto oStamp { toFileStamp(historyFile) };
+
+  if (!oStamp.has_value()) { return; }
+
+  BlobWriter w;
+  w.write(MAGIC);
+  w.write(VERSION);
+  w.writeString(historyFile.lexically_normal().string());
+  w.write(oStamp.value());
+  w.writeString(site.getName());
+  writeSite(w, site);
+  std::error_code ec;
+
+  // a new cache directory is private to the user, as load() trusts the files it finds there
+  if (std::filesystem::create_directories(m_dir, ec)) {
+    std::filesystem::permissions(m_dir, std::filesystem::perms::owner_all, ec);
+  }
+
+  const auto cacheFile { toCacheFile(m_dir, historyFile) };
+  // write then rename, so that a concurrent reader never sees a partially written cache file
+  auto tmpFile { cacheFile };
+  tmpFile += std::format(".{}.tmp", std::hash<std::thread::id> {}(std::this_thread::get_id()));
+  {
+    std::ofstream out { tmpFile, std::ios::binary | std::ios::trunc };
+    const auto bytes { w.getBytes() };
+    out.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+
+    if (!out) { std::filesystem::remove(tmpFile, ec); return; }
+  }
+  std::filesystem::rename(tmpFile, cacheFile, ec);
+}
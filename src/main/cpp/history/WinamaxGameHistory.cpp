@@ -3,12 +3,16 @@ module;
 export module history.WinamaxGameHistory;
 
 import entities.Hand;
+import entities.HandId;
 import entities.Game; // Limit
 import entities.Player;
 import entities.Site;
 import history.GameData;
 import history.WinamaxHandBuilder;
 import language.strings; // language::strings::contains()
+import system.Logger;
+import system.MappedFile;
+import system.MemoryArena;
 import system.PlayerCache;
 import system.TextFile;
 
@@ -17,10 +21,47 @@ import system.TextFile;
 import std;
 #pragma warning( pop ) 
 
+/**
+ * How far a history file, possibly still being written, has been parsed.
+ */
+export struct [[nodiscard]] HistoryFileTail final {
+  std::size_t parsedSize { 0 }; // the offset of the byte following the last complete hand parsed
+  std::size_t nbHands { 0 }; // the number of hands parsed
+  std::size_t nbSkippedHands { 0 }; // the number of malformed hands skipped
+};
+
 export namespace WinamaxGameHistory {
-[[nodiscard]] std::unique_ptr<Site> parseGameHistory(const std::filesystem::path& gameHistoryFile);
+/**
+ * Parses the given history file. If a stop is requested through stopToken, the parsing stops
+ * between two hands and the returned Site contains the hands parsed so far.
+ * A big file is parsed by at most nbThreads threads, 0 meaning one per hardware thread, the
+ * calling thread being one of them.
+ * A malformed hand is skipped, the parsing going on at the next "Winamax Poker - " line. The
+ * number of skipped hands of the file is logged.
+ */
+[[nodiscard]] std::unique_ptr<Site> parseGameHistory(const std::filesystem::path& gameHistoryFile,
+    std::stop_token stopToken = {}, std::size_t nbThreads = 0);
 
 std::unique_ptr<Site> parseGameHistory(auto) = delete;
+
+/**
+ * Parses the complete hands written in gameHistoryFile after tail.parsedSize, then updates tail.
+ * A hand not yet followed by its empty lines, which Winamax may still be writing, is left for a
+ * later call.
+ * @returns a Site containing the game with only the newly parsed hands.
+ */
+[[nodiscard]] std::unique_ptr<Site> parseGameHistory(const std::filesystem::path& gameHistoryFile,
+    HistoryFileTail& tail);
+
+std::unique_ptr<Site> parseGameHistory(auto, HistoryFileTail&) = delete;
+
+/**
+ * @returns the ids of the hands of the given history file, in the file order, read from their
+ * "Winamax Poker - " lines without parsing the hands. Empty if the file can't be read.
+ */
+[[nodiscard]] std::vector<HandId> getHandIds(const std::filesystem::path& gameHistoryFile);
+
+std::vector<HandId> getHandIds(auto) = delete;
 }; // namespace WinamaxGameHistory
 
 module : private;
@@ -105,63 +146,319 @@ void fillFromFileName(const std::tuple<bool, std::string, Variant, Limit>& value
   gameData.m_limit = limit;
 }
 
+// each hand starts with a line like "Winamax Poker - CashGame - HandId: #..."
+static constexpr std::string_view HAND_START { "\nWinamax Poker - " };
+
+// moves tfl to the first line starting a hand, from the current line
+// @returns false at the end of the file
+[[nodiscard]] static bool moveToHandStart(TextFile& tfl) {
+  while (!tfl.startsWith(HAND_START.substr(1))) {
+    if (!tfl.next()) { return false; }
+  }
+
+  return true;
+}
+
+// the number of lines of a file before the part of it that a TextFile reads, so that the warnings
+// give the lines of the file. They are counted only for the first warning, as that reads the file
+// from its start.
+class [[nodiscard]] LinesBefore final {
+private:
+  std::string_view m_contentBefore;
+  std::optional<int> m_oNbLines {};
+
+public:
+  explicit LinesBefore(std::string_view contentBefore) noexcept : m_contentBefore { contentBefore } {}
+
+  [[nodiscard]] int get() {
+    if (!m_oNbLines.has_value()) { m_oNbLines = static_cast<int>(std::ranges::count(m_contentBefore, '\n')); }
+
+    return m_oNbLines.value();
+  }
+}; // class LinesBefore
+
+// a hand that could not be built is skipped: moves tfl after the hand start line, the next
+// moveToHandStart() finding the next hand
+// @returns false at the end of the file
+[[nodiscard]] static bool skipHand(TextFile& tfl, int handStartLine, const HandParseError& error,
+                                   LinesBefore& linesBefore) {
+  logger::warning(LogCategory::parser, "Hand skipped in {} at line {}: {}.", tfl.getFileStem(),
+                  linesBefore.get() + error.lineIndex, error.reason);
+  return handStartLine != tfl.getLineIndex() or tfl.next();
+}
+
+// parses the hands of tfl, the first valid one giving the game data
+// @param contentBefore the content of the file before the one of tfl
 template <typename GAME_TYPE> [[nodiscard]]
-std::unique_ptr<GAME_TYPE> createGame(const std::filesystem::path& gameHistoryFile,
-                                      PlayerCache& cache) {
-  const auto& fileStem { language::strings::sanitize(gameHistoryFile.stem().string()) };
+std::unique_ptr<GAME_TYPE> parseGame(std::string_view fileStem,
+                                     const std::tuple<bool, std::string, Variant, Limit>& gameDataFromFileName, TextFile& tfl,
+                                     std::string_view contentBefore, PlayerCache& cache, std::stop_token stopToken,
+                                     std::size_t& nbSkippedHands) {
   std::unique_ptr<GAME_TYPE> ret;
+  const auto pArena { std::make_shared<MemoryArena>() };
+  LinesBefore linesBefore { contentBefore };
+
+  while (!stopToken.stop_requested() and moveToHandStart(tfl)) {
+    const auto handStartLine { tfl.getLineIndex() };
+    std::optional<HandParseError> oError;
+
+    if (nullptr == ret) {
+      if (auto handAndGameData { WinamaxHandBuilder::buildHandAndGameData<GAME_TYPE>(tfl, cache, *pArena) };
+          handAndGameData.has_value()) {
+        auto& [pHand, pGameData] { handAndGameData.value() };
+        fillFromFileName(gameDataFromFileName, *pGameData);
+        ret = newGame<GAME_TYPE>(fileStem, *pGameData);
+        ret->addHand(std::move(pHand), pArena);
+      } else { oError = handAndGameData.error(); }
+    } else {
+      logger::trace(LogCategory::parser, "not the 1st hand : adding the new hand to the existing game history.");
+
+      if (auto pHand { WinamaxHandBuilder::buildHand<GAME_TYPE>(tfl, cache, *pArena) }; pHand.has_value()) {
+        ret->addHand(std::move(pHand.value()), pArena);
+      } else { oError = pHand.error(); }
+    }
 
-  if (const auto & oGameDataFromFileName { parseFileStem(fileStem) };
-      oGameDataFromFileName.has_value()) {
-    TextFile tfl { gameHistoryFile };
+    if (oError.has_value()) {
+      ++nbSkippedHands;
 
-    while (tfl.next()) {
-      if (nullptr == ret) {
-        auto [pHand, pGameData] { WinamaxHandBuilder::buildHandAndGameData<GAME_TYPE>(tfl, cache) };
-        fillFromFileName(oGameDataFromFileName.value(), *pGameData);
-        ret = newGame<GAME_TYPE>(fileStem, *pGameData);
-        ret->addHand(std::move(pHand));
-      } else {
-        std::println("not the 1st hand : adding the new hand to the existing game history.");
-        ret->addHand(WinamaxHandBuilder::buildHand<GAME_TYPE>(tfl, cache));
-      }
+      if (!skipHand(tfl, handStartLine, oError.value(), linesBefore)) { break; }
+    }
+  }
+
+  return ret;
+}
+
+// a history file smaller than twice this size is parsed by a single thread
+static constexpr std::size_t MIN_CHUNK_SIZE { 1024 * 1024 };
+
+// splits content into at most nbMaxChunks consecutive parts of about the same size, each part
+// but the first starting at the beginning of a hand
+[[nodiscard]] static std::vector<std::string_view> splitAtHandStarts(std::string_view content,
+    std::size_t nbMaxChunks) {
+  std::vector<std::string_view> ret;
+  std::size_t chunkStart { 0 };
+
+  for (std::size_t i { 1 }; i < nbMaxChunks; ++i) {
+    const auto pos { content.find(HAND_START, std::max(chunkStart, content.size() / nbMaxChunks * i)) };
+
+    if (std::string_view::npos == pos) { break; }
+
+    ret.push_back(content.substr(chunkStart, pos + 1 - chunkStart));
+    chunkStart = pos + 1;
+  }
+
+  ret.push_back(content.substr(chunkStart));
+  return ret;
+}
+
+// nbThreads being 0 means one per hardware thread
+[[nodiscard]] static std::size_t getNbChunks(std::size_t contentSize, std::size_t nbThreads) noexcept {
+  const std::size_t nbMaxChunks { 0 == nbThreads ? std::max(1U, std::thread::hardware_concurrency()) : nbThreads };
+  return std::max<std::size_t>(1, std::min(nbMaxChunks, contentSize / MIN_CHUNK_SIZE));
+}
+
+struct [[nodiscard]] ParsedChunk final {
+  std::shared_ptr<MemoryArena> pArena { std::make_shared<MemoryArena>() }; // first, so that it outlives the hands
+  std::vector<ArenaPtr<Hand>> hands {};
+  std::vector<std::unique_ptr<Player>> players {};
+  std::size_t nbSkippedHands { 0 };
+};
+
+// parses a part of a history file which does not contain its first hand
+// @param contentBefore the content of the file before chunk
+template <typename GAME_TYPE>
+[[nodiscard]] ParsedChunk parseChunk(const std::filesystem::path& gameHistoryFile, std::string_view chunk,
+                                    std::string_view contentBefore, std::stop_token stopToken) {
+  TextFile tfl { gameHistoryFile, chunk };
+  PlayerCache cache { WINAMAX_SITE_NAME };
+  ParsedChunk ret;
+  LinesBefore linesBefore { contentBefore };
+
+  while (!stopToken.stop_requested() and moveToHandStart(tfl)) {
+    const auto handStartLine { tfl.getLineIndex() };
+
+    if (auto pHand { WinamaxHandBuilder::buildHand<GAME_TYPE>(tfl, cache, *ret.pArena) }; pHand.has_value()) {
+      ret.hands.push_back(std::move(pHand.value()));
+    } else {
+      ++ret.nbSkippedHands;
+
+      if (!skipHand(tfl, handStartLine, pHand.error(), linesBefore)) { break; }
     }
   }
 
+  ret.players = cache.extractPlayers();
   return ret;
 }
 
+template <typename GAME_TYPE> [[nodiscard]]
+std::unique_ptr<GAME_TYPE> createGame(const std::filesystem::path& gameHistoryFile, TextFile& tfl,
+                                      PlayerCache& cache, std::stop_token stopToken, std::size_t nbThreads,
+                                      std::size_t& nbSkippedHands) {
+  const auto& fileStem { language::strings::sanitize(gameHistoryFile.stem().string()) };
+  const auto& oGameDataFromFileName { parseFileStem(fileStem) };
+
+  if (!oGameDataFromFileName.has_value()) { return nullptr; }
+
+  const auto content { tfl.getContent() };
+  const auto& chunks { splitAtHandStarts(content, getNbChunks(content.size(), nbThreads)) };
+
+  if (2 > chunks.size()) {
+    return parseGame<GAME_TYPE>(fileStem, oGameDataFromFileName.value(), tfl, {}, cache, stopToken, nbSkippedHands);
+  }
+
+  const auto getContentBefore { [content](std::string_view chunk) {
+    return content.substr(0, static_cast<std::size_t>(chunk.data() - content.data()));
+  } };
+
+  // The other chunks are parsed by their own threads while this thread parses the first one. There
+  // are at most nbThreads - 1 of them, so that an import running several files at once gives here
+  // only the threads that its workers leave unused.
+  std::vector<std::future<ParsedChunk>> otherChunks;
+  otherChunks.reserve(chunks.size() - 1);
+  std::transform(std::next(std::begin(chunks)), std::end(chunks), std::back_inserter(otherChunks),
+  [&gameHistoryFile, &stopToken, &getContentBefore](std::string_view chunk) {
+    return std::async(std::launch::async, [&gameHistoryFile, chunk, contentBefore = getContentBefore(chunk), stopToken]() {
+      return parseChunk<GAME_TYPE>(gameHistoryFile, chunk, contentBefore, stopToken);
+    });
+  });
+  TextFile firstChunk { gameHistoryFile, chunks.front() };
+  auto ret { parseGame<GAME_TYPE>(fileStem, oGameDataFromFileName.value(), firstChunk, {}, cache, stopToken, nbSkippedHands) };
+
+  // the hands are added in the file order
+  for (std::size_t i { 1 }; i < chunks.size(); ++i) {
+    auto [pArena, hands, players, nbChunkSkippedHands] { otherChunks[i - 1].get() };
+
+    if (nullptr == ret) {
+      // no hand before this chunk gave the game data: the chunk is parsed again, its first valid
+      // hand giving them
+      TextFile chunk { gameHistoryFile, chunks[i] };
+      ret = parseGame<GAME_TYPE>(fileStem, oGameDataFromFileName.value(), chunk, getContentBefore(chunks[i]), cache,
+                                 stopToken, nbSkippedHands);
+      continue;
+    }
+
+    nbSkippedHands += nbChunkSkippedHands;
+    std::ranges::for_each(hands, [&ret, &pArena](auto & pHand) { ret->addHand(std::move(pHand), pArena); });
+    std::ranges::for_each(players, [&cache](const auto & pPlayer) {
+      cache.addIfMissing(pPlayer->getName());
+
+      if (pPlayer->isHero()) { cache.setIsHero(pPlayer->getName()); }
+    });
+  }
+
+  return ret;
+}
+
+struct [[nodiscard]] ParsedHands final {
+  std::unique_ptr<Site> pSite;
+  std::size_t nbHands { 0 };
+  std::size_t nbSkippedHands { 0 };
+};
+
 template<typename GAME_TYPE>
-[[nodiscard]]  std::unique_ptr<Site> handleGame(const std::filesystem::path& gameHistoryFile) {
-  auto pSite { std::make_unique<Site>(WINAMAX_SITE_NAME) };
+[[nodiscard]] ParsedHands handleGame(const std::filesystem::path& gameHistoryFile,
+                                     TextFile& tfl, std::stop_token stopToken, std::size_t nbThreads) {
+  ParsedHands ret { .pSite = std::make_unique<Site>(WINAMAX_SITE_NAME) };
   PlayerCache cache { WINAMAX_SITE_NAME };
 
-  if (auto g { createGame<GAME_TYPE>(gameHistoryFile, cache) }; nullptr != g) {
-    std::println("Game created for file {}.", gameHistoryFile.filename().string());
-    pSite->addGame(std::move(g));
+  if (auto g { createGame<GAME_TYPE>(gameHistoryFile, tfl, cache, stopToken, nbThreads, ret.nbSkippedHands) }; nullptr != g) {
+    logger::debug(LogCategory::parser, "Game created for file {}.", gameHistoryFile.filename().string());
+    ret.nbHands = g->getNbHands();
+    ret.pSite->addGame(std::move(g));
   } else {
-    std::println(std::cerr, "Game *not* created for file {}.", gameHistoryFile.filename().string());
+    logger::warning(LogCategory::parser, "Game *not* created for file {}.", gameHistoryFile.filename().string());
+  }
+
+  if (0 < ret.nbSkippedHands) {
+    logger::warning(LogCategory::parser, "{} malformed hands skipped in file {}.", ret.nbSkippedHands,
+                    gameHistoryFile.filename().string());
   }
 
   auto players { cache.extractPlayers() };
-  std::ranges::for_each(players, [&](auto & p) { pSite->addPlayer(std::move(p)); });
-  return pSite;
+  std::ranges::for_each(players, [&](auto & p) { ret.pSite->addPlayer(std::move(p)); });
+  return ret;
+}
+
+[[nodiscard]] static bool isParsable(const std::filesystem::path& gameHistoryFile) {
+  const auto& fileStem { gameHistoryFile.stem().string() };
+  return 12 <= fileStem.size()
+         and gameHistoryFile.extension() == ".txt"
+         and !fileStem.contains("_summary")
+         and (std::string::npos != fileStem.find("_real_", 9)
+              or std::string::npos != fileStem.find("_play_", 9));
+}
+
+[[nodiscard]] static ParsedHands parseHands(
+  const std::filesystem::path& gameHistoryFile, TextFile& tfl, std::stop_token stopToken, std::size_t nbThreads) {
+  return gameHistoryFile.stem().string().contains('(')
+         ? handleGame<Tournament>(gameHistoryFile, tfl, stopToken, nbThreads)
+         : handleGame<CashGame>(gameHistoryFile, tfl, stopToken, nbThreads);
 }
 
 // reminder: WinamaxGameHistory is a namespace
 std::unique_ptr<Site> WinamaxGameHistory::parseGameHistory(const std::filesystem::path&
-    gameHistoryFile) {
-  const auto& fileStem { gameHistoryFile.stem().string() };
+    gameHistoryFile, std::stop_token stopToken, std::size_t nbThreads) {
+  if (!isParsable(gameHistoryFile)) { return std::make_unique<Site>(WINAMAX_SITE_NAME); }
+
+  TextFile tfl { gameHistoryFile };
+  return std::move(parseHands(gameHistoryFile, tfl, stopToken, nbThreads).pSite);
+}
+
+// a hand is followed by two empty lines once Winamax has finished writing it
+// @returns the size of the beginning of content made of complete hands
+[[nodiscard]] static constexpr std::size_t getCompleteHandsSize(std::string_view content) noexcept {
+  const auto unixEnd { content.rfind("\n\n\n") };
+  const auto windowsEnd { content.rfind("\n\r\n\r\n") };
+  const auto unixSize { std::string_view::npos == unixEnd ? 0 : unixEnd + 3 };
+  const auto windowsSize { std::string_view::npos == windowsEnd ? 0 : windowsEnd + 5 };
+  return std::max(unixSize, windowsSize);
+}
+
+std::unique_ptr<Site> WinamaxGameHistory::parseGameHistory(const std::filesystem::path&
+    gameHistoryFile, HistoryFileTail& tail) {
+  if (!isParsable(gameHistoryFile)) { return std::make_unique<Site>(WINAMAX_SITE_NAME); }
+
+  const MappedFile mapping { gameHistoryFile };
+  const auto content { mapping.view() };
+
+  // Winamax only appends to its history files, a smaller file has nothing new for us
+  if (content.size() <= tail.parsedSize) { return std::make_unique<Site>(WINAMAX_SITE_NAME); }
+
+  const auto appendedContent { content.substr(tail.parsedSize) };
+  const auto completeHandsSize { getCompleteHandsSize(appendedContent) };
 
-  if (12 > fileStem.size()
-      or gameHistoryFile.extension() != ".txt"
-      or fileStem.contains("_summary")
-      or fileStem.contains('!') // history files with an '!' in their title are duplicated with another name, so ignore it
-      or (std::string::npos == fileStem.find("_real_", 9)
-          and std::string::npos == fileStem.find("_play_", 9))) {
-    return std::make_unique<Site>(WINAMAX_SITE_NAME);
+  if (0 == completeHandsSize) { return std::make_unique<Site>(WINAMAX_SITE_NAME); }
+
+  TextFile tfl { gameHistoryFile, appendedContent.substr(0, completeHandsSize) };
+  auto [pSite, nbHands, nbSkippedHands] { parseHands(gameHistoryFile, tfl, {}, 0) };
+  tail.parsedSize += completeHandsSize;
+  tail.nbHands += nbHands;
+  tail.nbSkippedHands += nbSkippedHands;
+  return std::move(pSite);
+}
+
+std::vector<HandId> WinamaxGameHistory::getHandIds(const std::filesystem::path& gameHistoryFile) {
+  if (!isParsable(gameHistoryFile)) { return {}; }
+
+  static constexpr std::string_view ID_START { "HandId: #" };
+  const MappedFile mapping { gameHistoryFile };
+  const auto content { mapping.view() };
+  std::vector<HandId> ret;
+  const auto addHandId { [content, &ret](std::size_t lineStart) {
+    const auto line { content.substr(lineStart, content.find('\n', lineStart) - lineStart) };
+
+    if (const auto idStart { line.find(ID_START) }; std::string_view::npos != idStart) {
+      const auto id { line.substr(idStart + ID_START.size()) };
+
+      if (const auto oHandId { HandId::parse(id.substr(0, id.find(' '))) }; oHandId.has_value()) { ret.push_back(oHandId.value()); }
+    }
+  } };
+
+  if (content.starts_with(HAND_START.substr(1))) { addHandId(0); }
+
+  for (auto pos { content.find(HAND_START) }; std::string_view::npos != pos; pos = content.find(HAND_START, pos + 1)) {
+    addHandId(pos + 1);
   }
 
-  return fileStem.contains('(') ? handleGame<Tournament>(gameHistoryFile)
-         : handleGame<CashGame>(gameHistoryFile);
+  return ret;
 }
@@ -8,12 +8,17 @@ import entities.Card;
 import entities.Game; // CashGame, Tournament
 import entities.GameType;
 import entities.Hand;
+import entities.HandId;
 //import entities.Player;
 import entities.Seat;
 import history.GameData;
-import language.containers;
+import history.WinamaxLine;
 import language.strings;
+import system.Logger;
+import system.MemoryArena;
+import system.Money;
 import system.PlayerCache;
+import system.StringPool;
 import system.TextFile;
 import system.Time;
 
@@ -22,36 +27,51 @@ import system.Time;
 import std;
 #pragma warning( pop ) 
 
+/**
+ * Why a hand could not be built. The parsing can go on from the next hand.
+ */
+export struct [[nodiscard]] HandParseError final {
+  std::string_view reason; // a string literal
+  int lineIndex { 0 }; // the line where the error was found
+};
+
+export template<typename T>
+using HandParseResult = std::expected<T, HandParseError>;
+
 export namespace WinamaxHandBuilder {
-[[nodiscard]] std::pair<std::unique_ptr<Hand>, std::unique_ptr<GameData>>
+/**
+ * The build functions read a hand from its "Winamax Poker - " line. They do not throw on malformed or
+ * truncated input: they return the error, leaving tfl on the line where it was found.
+ */
+[[nodiscard]] HandParseResult<std::pair<ArenaPtr<Hand>, std::unique_ptr<GameData>>>
     buildCashgameHandAndGameData(TextFile& tfl,
-                                 PlayerCache& pc);
+                                 PlayerCache& pc, MemoryArena& arena);
 
-[[nodiscard]] std::pair<std::unique_ptr<Hand>, std::unique_ptr<GameData>>
+[[nodiscard]] HandParseResult<std::pair<ArenaPtr<Hand>, std::unique_ptr<GameData>>>
     buildTournamentHandAndGameData(
-      TextFile& tfl, PlayerCache& pc);
+      TextFile& tfl, PlayerCache& pc, MemoryArena& arena);
 
 template<typename GAME_TYPE>
-[[nodiscard]] std::pair<std::unique_ptr<Hand>, std::unique_ptr<GameData>> buildHandAndGameData(
+[[nodiscard]] HandParseResult<std::pair<ArenaPtr<Hand>, std::unique_ptr<GameData>>> buildHandAndGameData(
       TextFile& tfl,
-PlayerCache& pc) {
+PlayerCache& pc, MemoryArena& arena) {
   static_assert(std::is_same_v<GAME_TYPE, CashGame> or std::is_same_v<GAME_TYPE, Tournament>);
 
-  if constexpr(std::is_same_v<GAME_TYPE, CashGame>) { return buildCashgameHandAndGameData(tfl, pc); }
+  if constexpr(std::is_same_v<GAME_TYPE, CashGame>) { return buildCashgameHandAndGameData(tfl, pc, arena); }
 
-  if constexpr(std::is_same_v<GAME_TYPE, Tournament>) { return buildTournamentHandAndGameData(tfl, pc); }
+  if constexpr(std::is_same_v<GAME_TYPE, Tournament>) { return buildTournamentHandAndGameData(tfl, pc, arena); }
 }
 
-[[nodiscard]] std::unique_ptr<Hand> buildCashgameHand(TextFile& tfl, PlayerCache& pc);
-[[nodiscard]] std::unique_ptr<Hand> buildTournamentHand(TextFile& tfl, PlayerCache& pc);
+[[nodiscard]] HandParseResult<ArenaPtr<Hand>> buildCashgameHand(TextFile& tfl, PlayerCache& pc, MemoryArena& arena);
+[[nodiscard]] HandParseResult<ArenaPtr<Hand>> buildTournamentHand(TextFile& tfl, PlayerCache& pc, MemoryArena& arena);
 
 template<typename GAME_TYPE>
-[[nodiscard]] std::unique_ptr<Hand> buildHand(TextFile& tfl, PlayerCache& pc) {
+[[nodiscard]] HandParseResult<ArenaPtr<Hand>> buildHand(TextFile& tfl, PlayerCache& pc, MemoryArena& arena) {
   static_assert(std::is_same_v<GAME_TYPE, CashGame> or std::is_same_v<GAME_TYPE, Tournament>);
 
-  if constexpr(std::is_same_v<GAME_TYPE, CashGame>) { return buildCashgameHand(tfl, pc); }
+  if constexpr(std::is_same_v<GAME_TYPE, CashGame>) { return buildCashgameHand(tfl, pc, arena); }
 
-  if constexpr(std::is_same_v<GAME_TYPE, Tournament>) { return buildTournamentHand(tfl, pc); }
+  if constexpr(std::is_same_v<GAME_TYPE, Tournament>) { return buildTournamentHand(tfl, pc, arena); }
 }
 } // namespace WinamaxHandBuilder
 
@@ -59,322 +79,313 @@ module : private;
 
 constexpr static std::array FIVE_NONE_CARDS { Card::none, Card::none, Card::none, Card::none, Card::none };
 
-// splits the given str into tokens, separated by delimiters.
-// We assume there are always 5 tokens
-[[nodiscard]] std::array<std::string_view, 5> split(std::string_view str,
-    std::string_view delimiter) {
-  std::array<std::string_view, 5> ret { "none", "none", "none", "none", "none" };
-  std::size_t offset = 0, delimiterPosition = 0, arrayIndex = 0;
-
-  while (std::string_view::npos != (delimiterPosition = str.find(delimiter, offset))) {
-    ret.at(arrayIndex) = str.substr(offset, delimiterPosition - offset);
-    offset = delimiterPosition + delimiter.size();
-    arrayIndex++;
-  }
+// "... [Ah Kd]" or "Board: [Jc 8d 5s 3h 2d]"
+[[nodiscard]] static std::array<Card, 5> parseCards(std::string_view line) {
+  const auto pos { line.rfind('[') + 1 };
+  const auto strCards { line.substr(pos, line.rfind(']') - pos) };
+  auto ret { FIVE_NONE_CARDS };
 
-  if (offset != str.size() - 1) {
-    ret.at(arrayIndex) = str.substr(offset);
+  // each card is a rank and a suit, the cards are separated by a space
+  for (std::size_t i { 0 }, cardIndex { 0 }; i + 1 < strCards.size() and cardIndex < ret.size(); i += 3, ++cardIndex) {
+    ret[cardIndex] = toCard(strCards[i], strCards[i + 1]);
   }
 
   return ret;
 }
 
-[[nodiscard]] static std::array<Card, 5> parseCards(std::string_view line) {
-  const auto pos { line.rfind('[') + 1 };
-  const auto strCards { line.substr(pos, line.rfind(']') - pos) };
-  const auto& cardsStr { split(strCards, " ") };
-  std::array<Card, 5> ret;
-  std::transform(std::begin(cardsStr), std::end(cardsStr), std::begin(ret), toCard);
-  return ret;
+static constexpr std::string_view WINAMAX_HISTORY_TIME_FORMAT { "%Y/%m/%d %H:%M:%S" }; // ex: 2014/10/31 00:45:01
+
+// Winamax Poker - Go Fast "Colorado" - HandId: #18876...-1549... - Holdem no limit (0.01€/0.02€) - 2019/02/06 08:22:31 UTC
+using WinamaxPokerLine = language::strings::LinePattern<"^Winamax Poker - .* - HandId: #(.*?) - .* - (.*) UTC$">;
+using CashGameWinamaxPokerLine =
+  language::strings::LinePattern<"^Winamax Poker - .* - HandId: #(.*?) - .* \\((.*?)/(.*?)\\) - (.*) UTC$">;
+// Winamax Poker - Tournament "Freeroll" buyIn: 0.45€ + 0.05€ level: 1 - HandId: #... - Holdem no limit (10/20) - 2019/02/06 08:22:31 UTC
+using TournamentWinamaxPokerLine =
+  language::strings::LinePattern<"^Winamax Poker - .* buyIn: (.*?) level: (.*?) - HandId: #(.*?) - .* - (.*) UTC$">;
+// Table: 'Frankfurt 11' 9-max (real money) Seat #2 is the button
+// Table: 'Expresso(111550795)#0' 3-max (real money) Seat #1 is the button
+using TableLine = language::strings::LinePattern<"^Table: '(.*?)' (.*?)-max .* Seat #(.*) is the button$">;
+
+[[nodiscard]] static std::unexpected<HandParseError> toError(const TextFile& tf, std::string_view reason) {
+  return std::unexpected(HandParseError { .reason = reason, .lineIndex = tf.getLineIndex() });
 }
 
+static constexpr std::string_view TRUNCATED_HAND { "the hand is truncated" };
 
-static constexpr auto MINUS_LENGTH { language::strings::length(" - ") }; // nb char without '\0
-static constexpr auto HAND_ID_LENGTH { language::strings::length(" - HandId: #") }; // nb char without '\0
-static constexpr std::string_view WINAMAX_HISTORY_TIME_FORMAT { "%Y/%m/%d %H:%M:%S" }; // ex: 2014/10/31 00:45:01
+// moves to the next line of the current hand
+[[nodiscard]] static HandParseResult<void> nextHandLine(TextFile& tf) {
+  if (!tf.next()) { return toError(tf, TRUNCATED_HAND); }
 
-// Returns the HandId position, the Hand start time and the Hand Id
-[[nodiscard]] std::tuple<std::size_t, Time, std::string>
-parseStartOfWinamaxPokerLine(std::string_view line) {
-  // "^Winamax Poker - .* - HandId: #(.*) .*  - (.*) UTC$"
-  if (!line.starts_with("Winamax Poker")) { throw "a Winamax poker line should start with 'Winamax Poker'"; }
+  return {};
+}
 
-  if (!line.ends_with("UTC")) { throw "a Winamax poker line should end with 'UTC'"; }
+template<typename PATTERN>
+[[nodiscard]] static HandParseResult<typename PATTERN::Captures> matchWinamaxPokerLine(const TextFile& tf) {
+  if (const auto oCaptures { PATTERN::match(tf.getLine()) }; oCaptures.has_value()) { return oCaptures.value(); }
 
-  const auto datePos { line.rfind(" - ") + MINUS_LENGTH }; // nb char without '\0'
+  return toError(tf, "a Winamax poker line should be 'Winamax Poker - ... - HandId: #... UTC'");
+}
 
-  if (datePos >= line.length()) { throw "bad datePos"; }
+[[nodiscard]] static HandParseResult<HandId> toHandId(const TextFile& tf, std::string_view handId) {
+  if (const auto oHandId { HandId::parse(handId) }; oHandId.has_value()) { return oHandId.value(); }
 
-  const Time handStartDate({ .strTime = line.substr(datePos, line.rfind(' ') - datePos), .format = WINAMAX_HISTORY_TIME_FORMAT });
-  const auto handIdPos { line.find(" - HandId: #") + HAND_ID_LENGTH };
-  const auto handId { line.substr(handIdPos, line.find(" - ", handIdPos) - handIdPos) };
-  return { handIdPos, handStartDate, std::string(handId) };
+  return toError(tf, "the hand id should be 3 numbers such as '12266668-4174329-1549487680'");
 }
 
-static constexpr auto BUY_IN_LENGTH { language::strings::length(" buyIn: ") }; // nb char without '\0
-static constexpr auto LEVEL_LENGTH { language::strings::length(" level: ") }; // nb char without '\0
-
-[[nodiscard]]  std::tuple<double, int, Time, std::string>
-getBuyInLevelDateHandIdFromTournamentWinamaxPokerLine(std::string_view line) {
-  const auto& [handIdPos, handStartDate, handId] { parseStartOfWinamaxPokerLine(line) };
-  // "^Winamax Poker - .* buyIn: (.*) level: (.*) - HandId: #(.*) - .* - (.*) UTC$"
-  const auto buyInPos { line.find(" buyIn: ") + BUY_IN_LENGTH };
-  const auto levelPos { line.find(" level: ") + LEVEL_LENGTH };
-  const auto buyIn { language::strings::toBuyIn(line.substr(buyInPos, levelPos - LEVEL_LENGTH - buyInPos)) };
-  const auto level { language::strings::toInt(line.substr(levelPos, handIdPos - HAND_ID_LENGTH - levelPos)) };
-  return { buyIn, level, handStartDate, handId };
-}
+// Returns the Hand start time and the Hand Id
+[[nodiscard]] HandParseResult<std::pair<Time, HandId>>
+parseStartOfWinamaxPokerLine(const TextFile& tf) {
+  const auto captures { matchWinamaxPokerLine<WinamaxPokerLine>(tf) };
+
+  if (!captures.has_value()) { return std::unexpected(captures.error()); }
+
+  const auto [handId, date] { captures.value() };
+  const auto id { toHandId(tf, handId) };
+
+  if (!id.has_value()) { return std::unexpected(id.error()); }
+
+  const auto oDate { Time::parse({ .strTime = date, .format = WINAMAX_HISTORY_TIME_FORMAT }) };
 
-[[nodiscard]]  std::tuple<int, Time, std::string>
-getLevelDateHandIdFromTournamentWinamaxPokerLine(std::string_view line) {
-  const auto& [handIdPos, handStartDate, handId] { parseStartOfWinamaxPokerLine(line) };
-  // "^Winamax Poker - .* buyIn: (.*) level: (.*) - HandId: #(.*) - .* - (.*) UTC$"
-  const auto levelPos { line.find(" level: ") + LEVEL_LENGTH };
-  const auto level { language::strings::toInt(line.substr(levelPos, handIdPos - HAND_ID_LENGTH - levelPos)) };
-  return { level, handStartDate, handId };
+  if (!oDate.has_value()) { return toError(tf, "the hand start date is not valid"); }
+
+  return std::pair { oDate.value(), id.value() };
 }
 
-[[nodiscard]]  std::tuple<double, double, Time, std::string>
-getSmallBlindBigBlindDateHandIdFromCashGameWinamaxPokerLine(std::string_view line) {
-  const auto& [_, handStartDate, handId] { parseStartOfWinamaxPokerLine(line) };
-  // "^Winamax Poker - .* - HandId: #(.*) - .* \\((.*)/(.*)\\) - (.*) UTC$"
-  const auto smallBlindPos { line.find('(') + 1 };
-  const auto bigBlindPos { line.find('/') + 1 };
-  const auto smallBlind { language::strings::toAmount(line.substr(smallBlindPos, bigBlindPos - 1 - smallBlindPos)) };
-  const auto bigBlind { language::strings::toAmount(line.substr(bigBlindPos, line.find(')') - 1)) };
-  return { smallBlind, bigBlind, handStartDate, handId };
+[[nodiscard]] HandParseResult<std::tuple<Money, int, Time, HandId>>
+getBuyInLevelDateHandIdFromTournamentWinamaxPokerLine(const TextFile& tf) {
+  const auto captures { matchWinamaxPokerLine<TournamentWinamaxPokerLine>(tf) };
+
+  if (!captures.has_value()) { return std::unexpected(captures.error()); }
+
+  const auto [buyIn, level, handId, date] { captures.value() };
+  const auto id { toHandId(tf, handId) };
+
+  if (!id.has_value()) { return std::unexpected(id.error()); }
+
+  const auto oDate { Time::parse({ .strTime = date, .format = WINAMAX_HISTORY_TIME_FORMAT }) };
+
+  if (!oDate.has_value()) { return toError(tf, "the hand start date is not valid"); }
+
+  return std::tuple { money::parseBuyIn(buyIn), language::strings::toInt(level), oDate.value(), id.value() };
 }
 
-static constexpr auto DEALT_TO_LENGTH { language::strings::length("Dealt to ") };
+[[nodiscard]] HandParseResult<std::tuple<Money, Money, Time, HandId>>
+getSmallBlindBigBlindDateHandIdFromCashGameWinamaxPokerLine(const TextFile& tf) {
+  const auto captures { matchWinamaxPokerLine<CashGameWinamaxPokerLine>(tf) };
 
-[[nodiscard]]  std::array<Card, 5> parseHeroCards(TextFile& tf,
+  if (!captures.has_value()) { return std::unexpected(captures.error()); }
+
+  const auto [handId, smallBlind, bigBlind, date] { captures.value() };
+  const auto id { toHandId(tf, handId) };
+
+  if (!id.has_value()) { return std::unexpected(id.error()); }
+
+  const auto oDate { Time::parse({ .strTime = date, .format = WINAMAX_HISTORY_TIME_FORMAT }) };
+
+  if (!oDate.has_value()) { return toError(tf, "the hand start date is not valid"); }
+
+  return std::tuple { money::parse(smallBlind), money::parse(bigBlind), oDate.value(),
+                      id.value() };
+}
+
+[[nodiscard]] HandParseResult<std::array<Card, 5>> parseHeroCards(TextFile& tf,
     PlayerCache& cache) {
-  std::println("Parsing hero cards for file {}.", tf.getFileStem());
-
-  if (tf.startsWith("Dealt to ")) {
-    const auto& line { tf.getLine() };
-    // "^Dealt to (.*) \\[(.*)\\]$"
-    const auto& playerName { line.substr(DEALT_TO_LENGTH, line.find(' ', DEALT_TO_LENGTH) - DEALT_TO_LENGTH) };
-    cache.setIsHero(playerName);
-    const auto& ret { parseCards(line) };
-    tf.next();
+  logger::trace(LogCategory::parser, "Parsing hero cards at line {}.", tf.getLineIndex());
+
+  // "^Dealt to (.*) \\[(.*)\\]$"
+  if (const auto line { winamaxLine::classify(tf.getLine()) }; WinamaxLineKind::dealtTo == line.kind) {
+    cache.setIsHero(line.playerName);
+    const auto& ret { parseCards(line.cards) };
+
+    if (const auto next { nextHandLine(tf) }; !next.has_value()) { return std::unexpected(next.error()); }
+
     return ret;
   }
 
   return FIVE_NONE_CARDS;
 }
 
-[[nodiscard]]  std::array<Card, 5> parseBoardCards(TextFile& tf) {
-  std::println("Parsing board cards for file {}.", tf.getFileStem());
+// the end of the file can follow the board, as the hand is complete
+[[nodiscard]] HandParseResult<std::array<Card, 5>> parseBoardCards(TextFile& tf) {
+  logger::trace(LogCategory::parser, "Parsing board cards at line {}.", tf.getLineIndex());
   std::array ret { FIVE_NONE_CARDS };
 
-  while (!tf.lineIsEmpty()) {
-    if (tf.startsWith("Board: ")) {
-      // "^Board: \\[([\\w\\s]+)\\]$"
-      ret = parseCards(tf.getLine());
-    }
+  for (auto line { winamaxLine::classify(tf.getLine()) }; WinamaxLineKind::empty != line.kind;
+       line = winamaxLine::classify(tf.getLine())) {
+    if (WinamaxLineKind::handStart == line.kind) { return toError(tf, "a hand starts in the summary"); }
 
-    tf.next();
+    // "^Board: \\[([\\w\\s]+)\\]$"
+    if (WinamaxLineKind::board == line.kind) { ret = parseCards(line.cards); }
+
+    if (!tf.next()) { return ret; }
   }
 
   tf.next();
   return ret;
 }
 
-[[nodiscard]]  Street parseStreet(TextFile& tf) {
-  auto street { Street::none }; // the current line can be *** ANTE/BLINDS ***
+// returns nbMaxSeats, tableName, buttonSeat, the table name being interned so that it outlives the line
+[[nodiscard]] HandParseResult<std::tuple<Seat, std::string_view, Seat>> getNbMaxSeatsTableNameButtonSeatFromTableLine(
+  TextFile& tf) {
+  if (const auto next { nextHandLine(tf) }; !next.has_value()) { return std::unexpected(next.error()); }
 
-  if (tf.startsWith("*** PRE-FLOP ***")) { street = Street::preflop; }
-  else if (tf.startsWith("*** FLOP ***")) { street = Street::flop; }
-  else if (tf.startsWith("*** TURN ***")) { street = Street::turn; }
-  else if (tf.startsWith("*** RIVER ***")) { street = Street::river; }
-  else if (tf.startsWith("*** SHOW DOWN ***")) { street = Street::river; }
+  const auto& line { tf.getLine() };
+  logger::trace(LogCategory::parser, "Parsing table line {}.", line);
+  const auto oCaptures { TableLine::match(line) };
 
-  tf.next();
-  return street;
-}
+  if (!oCaptures.has_value()) { return toError(tf, "a Table line should be 'Table: '...' N-max ... Seat #N is the button'"); }
 
-static constexpr auto TABLE_LENGTH { language::strings::length("Table: '") };
-static constexpr auto SEAT_NB_LENGTH { language::strings::length(" Seat #") };
+  const auto [tableNameStr, nbMaxSeatsStr, buttonSeatStr] { oCaptures.value() };
+  const auto oNbMaxSeats { tableSeat::parse(nbMaxSeatsStr) };
+  const auto oButtonSeat { tableSeat::parse(buttonSeatStr) };
 
-// returns nbMaxSeats, tableName, buttonSeat
-[[nodiscard]]  std::tuple<Seat, std::string, Seat> getNbMaxSeatsTableNameButtonSeatFromTableLine(
-  TextFile& tf) {
-  tf.next();
-  const auto& line { tf.getLine() };
-  std::println("Parsing table line {}.", line);
-  // Table: 'Frankfurt 11' 9-max (real money) Seat #2 is the button
-  // Table: 'Expresso(111550795)#0' 3-max (real money) Seat #1 is the button
-  // ^Table: '(.*)' (.*)-max .* Seat #(.*) is the button$
-  const auto pos { line.find("' ", TABLE_LENGTH) };
-  const auto& tableName { language::strings::sanitize(line.substr(TABLE_LENGTH, pos - TABLE_LENGTH)) };
-  const auto nbMaxSeats { tableSeat::fromString(line.substr(pos + 2, line.find("-max") - pos - 2)) };
-  const auto posSharp { line.find(" Seat #") + SEAT_NB_LENGTH };
-  const auto& buttonSeatStr { line.substr(posSharp, line.find(" is the button") - posSharp) };
-  const auto buttonSeat { tableSeat::fromString(buttonSeatStr) };
-
-  if (line.starts_with("Seat ")) { throw "a Table line should start with 'Seat '"; }
+  if (!oNbMaxSeats.has_value() or !oButtonSeat.has_value()) { return toError(tf, "the table seats are not valid"); }
 
-  tf.next();
-  return { nbMaxSeats, tableName, buttonSeat };
-}
+  const auto rawTableName { language::strings::myTrim(tableNameStr) };
 
-static constexpr auto POSTS_ANTE_LENGTH { language::strings::length(" posts ante ") };
+  if (rawTableName.empty()) { return toError(tf, "the table name is empty"); }
 
-[[nodiscard]]  long parseAnte(TextFile& tf) {
-  std::println("Parsing ante for file {}.", tf.getFileStem());
-  // "^(.*) posts m_ante (.*).*$"
-  long ret = 0;
+  // sanitizing copies the name, which is rarely needed
+  const auto tableName { rawTableName.contains('\'') ? stringPool::intern(language::strings::sanitize(rawTableName))
+                         : stringPool::intern(rawTableName) };
 
-  if (const auto posAnte { tf.find(" posts ante ") }; std::string::npos != posAnte) {
-    ret = language::strings::toInt(tf.getLine().substr(posAnte + POSTS_ANTE_LENGTH));
-  }
+  if (const auto next { nextHandLine(tf) }; !next.has_value()) { return std::unexpected(next.error()); }
 
-  while (tf.contains(" posts ")) { tf.next(); }
+  return std::tuple { oNbMaxSeats.value(), stringPool::view(tableName), oButtonSeat.value() };
+}
 
-  return ret;
+[[nodiscard]] static bool isPostsLine(const WinamaxLine& line) noexcept {
+  return WinamaxLineKind::postsAnte == line.kind or WinamaxLineKind::postsBlind == line.kind;
 }
 
-struct ActionParams {
-  std::string_view playerName;
-  ActionType actionType;
-  double betAmount;
-};
+[[nodiscard]] HandParseResult<long> parseAnte(TextFile& tf) {
+  logger::trace(LogCategory::parser, "Parsing ante at line {}.", tf.getLineIndex());
+  // "^(.*) posts ante (.*).*$"
+  long ret = 0;
 
-[[nodiscard]]  std::optional<ActionParams>
-parseActionParams(std::string_view line) {
-  if (line.ends_with(" folds")) {
-    return ActionParams { .playerName = line.substr(0, line.rfind(' ')),
-                          .actionType = ActionType::fold,
-                          .betAmount = 0.0
-                        };
-  }
+  for (auto line { winamaxLine::classify(tf.getLine()) }; isPostsLine(line); line = winamaxLine::classify(tf.getLine())) {
+    if (WinamaxLineKind::postsAnte == line.kind) { ret = language::strings::toInt(line.amount); }
 
-  if (line.ends_with(" checks")) {
-    return ActionParams {
-      .playerName = line.substr(0, line.rfind(' ')),
-      .actionType = ActionType::check,
-      .betAmount = 0.0
-    };
+    if (const auto next { nextHandLine(tf) }; !next.has_value()) { return std::unexpected(next.error()); }
   }
 
-  if (const auto pos = line.find(" calls "); std::string_view::npos != pos) {
-    return ActionParams {
-      .playerName = line.substr(0, pos),
-      .actionType = ActionType::call,
-      .betAmount = language::strings::toAmount(line.substr(line.rfind(' ') + 1))
-    };
-  }
+  return ret;
+}
 
-  if (const auto pos = line.find(" bets "); std::string_view::npos != pos) {
-    return ActionParams {
-      .playerName = line.substr(0, pos),
-      .actionType = ActionType::bet,
-      .betAmount = language::strings::toAmount(line.substr(line.rfind(' ') + 1))
-    };
-  }
+// appends the actions of each street, indexed from zero on each street, up to the first winner line.
+// Returns the last street.
+[[nodiscard]] static HandParseResult<Street> parseActions(TextFile& tf, std::vector<Action>& actions) {
+  auto street { Street::none };
+  auto firstIndex { actions.size() };
+
+  for (auto line { winamaxLine::classify(tf.getLine()) }; WinamaxLineKind::collected != line.kind;
+       line = winamaxLine::classify(tf.getLine())) {
+    if (WinamaxLineKind::action == line.kind) {
+      actions.emplace_back(Action::Params {
+        .playerId = stringPool::internPlayer(line.playerName),
+        .street = street,
+        .type = line.actionType,
+        .actionIndex = actions.size() - firstIndex,
+        .betAmount = line.amount.empty() ? Money {} : money::parse(line.amount) });
+    } else if (WinamaxLineKind::handStart == line.kind) {
+      return toError(tf, "a hand starts before the winners of the previous one");
+    } else if (WinamaxLineKind::shows != line.kind) {
+      // the street starts, the current line can be *** ANTE/BLINDS ***
+      street = line.street;
+      firstIndex = actions.size();
+    }
 
-  if (const auto pos = line.find(" raises "); std::string_view::npos != pos) {
-    return ActionParams {
-      .playerName = line.substr(0, pos),
-      .actionType = ActionType::raise,
-      .betAmount = language::strings::toAmount(line.substr(line.rfind(' ') + 1))
-    };
+    // nothing to do for 'shows' action
+    if (const auto next { nextHandLine(tf) }; !next.has_value()) { return std::unexpected(next.error()); }
   }
 
-  return {};
+  return street;
 }
 
-static constexpr std::array<std::string_view, 6> ACTION_TOKENS { " folds", " checks", " bets ", " calls ", " raises ", " shows " };
+// seats are the players of the hand, a winner being one of them
+[[nodiscard]] HandParseResult<std::array<PlayerId, 10>> parseWinners(TextFile& tf,
+    const std::array<PlayerId, 10>& seats) {
+  std::array<PlayerId, 10> winners {};
+  std::size_t i { 0 };
 
-[[nodiscard]]  std::vector<std::unique_ptr<Action>> parseActions(TextFile& tf, Street street,
-std::string_view handId) {
-  std::vector<std::unique_ptr<Action>> actions;
+  for (auto line { winamaxLine::classify(tf.getLine()) }; WinamaxLineKind::collected == line.kind;
+       line = winamaxLine::classify(tf.getLine())) {
+    if (winners.size() == i) { return toError(tf, "a hand has more than 10 winners"); }
 
-  while (tf.containsOneOf(ACTION_TOKENS)) {
-    const auto& line { tf.getLine() };
+    const auto winner { stringPool::internPlayer(line.playerName) };
 
-    if (const auto & oActionParams { parseActionParams(line) }; oActionParams.has_value()) {
-      const auto [playerName, type, bet] { oActionParams.value() };
-      actions.push_back(std::make_unique<Action>(Action::Params {
-        .handId = handId,
-        .playerName = playerName,
-        .street = street,
-        .type = type,
-        .actionIndex = actions.size(),
-        .betAmount = bet }));
+    if (PlayerId::none == winner or seats.end() == std::ranges::find(seats, winner)) {
+      return toError(tf, "a winner has no seat");
     }
 
-    tf.next(); // nothing to do for 'shows' action
-  }
-
-  return actions;
-}
-
-[[nodiscard]]  std::array<std::string, 10> parseWinners(TextFile& tf) {
-  std::array<std::string, 10> winners;
-  auto pos { std::string::npos };
-  std::size_t i { 0 };
+    winners[i++] = winner;
 
-  while (std::string::npos != (pos = tf.find(" collected "))) {
-    winners.at(i++) = tf.getLine().substr(0, pos);
-    tf.next();
+    if (const auto next { nextHandLine(tf) }; !next.has_value()) { return std::unexpected(next.error()); }
   }
 
   return winners;
 }
 
-[[nodiscard]]  std::vector<std::unique_ptr<Action>> createActionForWinnersWithoutAction(
-      std::span<std::string> winners, std::span<std::unique_ptr<Action>> actions, Street street,
-std::string_view handId) {
-  std::vector<std::unique_ptr<Action>> ret;
-  std::ranges::for_each(winners, [&](std::string_view winner) {
-    if (!winner.empty() and !language::containers::containsIf(actions, [&](auto & pAction) { return winner == pAction->getPlayerName(); })) {
-      ret.push_back(std::make_unique<Action>(Action::Params {
-        .handId = handId,
-        .playerName = winner,
+// appends an action without type, on the last street, for each winner who has no action at all in
+// the hand, such as a big blind that everybody folded to
+static void createActionForWinnersWithoutAction(std::span<const PlayerId> winners, Street street,
+    std::vector<Action>& actions) {
+  const auto nbActions { actions.size() };
+  std::ranges::for_each(winners, [&](PlayerId winner) {
+    const auto previousActionsEnd { actions.begin() + static_cast<std::ptrdiff_t>(nbActions) };
+
+    if (PlayerId::none != winner
+        and previousActionsEnd == std::ranges::find(actions.begin(), previousActionsEnd, winner, &Action::getPlayerId)) {
+      actions.emplace_back(Action::Params {
+        .playerId = winner,
         .street = street,
         .type = ActionType::none,
-        .actionIndex = actions.size() + ret.size(),
-        .betAmount = 0.0}));
+        .actionIndex = actions.size(),
+        .betAmount = {}});
     }
   });
-  return ret;
 }
 
-[[nodiscard]]  std::pair<std::vector<std::unique_ptr<Action>>, std::array<std::string, 10>>
-parseActionsAndWinners(TextFile& tf, std::string_view handId) {
-  std::println("Parsing actions and winners for file {}.", tf.getFileStem());
-  std::vector<std::unique_ptr<Action>> actions;
-  Street currentStreet = Street::none;
+// fills actions and returns the winners
+[[nodiscard]] HandParseResult<std::array<PlayerId, 10>> parseActionsAndWinners(TextFile& tf,
+    const std::array<PlayerId, 10>& seats, std::vector<Action>& actions) {
+  logger::trace(LogCategory::parser, "Parsing actions and winners at line {}.", tf.getLineIndex());
+  const auto lastStreet { parseActions(tf, actions) };
 
-  while (!tf.contains(" collected ")) {
-    currentStreet = parseStreet(tf);
-    auto currentActions { parseActions(tf, currentStreet, handId) };
-    language::containers::moveInto(currentActions, actions);
-  }
+  if (!lastStreet.has_value()) { return std::unexpected(lastStreet.error()); }
 
-  auto winners { parseWinners(tf) };
-  auto additionalActions { createActionForWinnersWithoutAction(winners, actions, currentStreet, handId) };
-  language::containers::moveInto(additionalActions, actions);
-  return { std::move(actions), winners };
-}
+  auto winners { parseWinners(tf, seats) };
 
-constexpr static auto SEAT_LENGTH { language::strings::length("Seat ") };
+  if (winners.has_value()) { createActionForWinnersWithoutAction(winners.value(), lastStreet.value(), actions); }
 
-[[nodiscard]] std::unordered_map<Seat, std::string> parseSeats(TextFile& tf,
+  return winners;
+}
+
+[[nodiscard]] HandParseResult<std::array<PlayerId, 10>> parseSeats(TextFile& tf,
     PlayerCache& /*cache*/) {
-  std::unordered_map<Seat, std::string> ret;
-
-  while (tf.startsWith("Seat ")) {
-    const auto& line { tf.getLine() };
-    const auto pos { line.find(": ", SEAT_LENGTH) };
-    const auto seat { tableSeat::fromString(line.substr(SEAT_LENGTH, pos - SEAT_LENGTH)) };
-    ret[seat] = line.substr(pos + 2, line.rfind(" (") - pos - 2);
-    tf.next();
+  std::array<PlayerId, 10> ret {};
+  auto line { winamaxLine::classify(tf.getLine()) };
+
+  for (; WinamaxLineKind::seat == line.kind; line = winamaxLine::classify(tf.getLine())) {
+    const auto oSeat { tableSeat::parse(line.seatNumber) };
+
+    if (!oSeat.has_value()) { return toError(tf, "a seat number should be between 1 and 10"); }
+
+    ret[tableSeat::toArrayIndex(oSeat.value())] = stringPool::internPlayer(line.playerName);
+
+    if (const auto next { nextHandLine(tf) }; !next.has_value()) { return std::unexpected(next.error()); }
   }
 
-  while (!tf.contains(" posts ")) { tf.next(); } // disreguard the blinds (lol)
+  if (2 > std::ranges::count_if(ret, [](PlayerId playerId) { return PlayerId::none != playerId; })) {
+    return toError(tf, "a hand needs at least 2 players");
+  }
+
+  // disreguard the blinds (lol)
+  for (; !isPostsLine(line); line = winamaxLine::classify(tf.getLine())) {
+    if (WinamaxLineKind::handStart == line.kind) { return toError(tf, "a hand starts before the blinds of the previous one"); }
+
+    if (const auto next { nextHandLine(tf) }; !next.has_value()) { return std::unexpected(next.error()); }
+  }
 
   return ret;
 }
@@ -382,55 +393,99 @@ constexpr static auto SEAT_LENGTH { language::strings::length("Seat ") };
 constexpr static auto WINAMAX_SITE_NAME { "Winamax" };
 
 template<GameType gameType>
-[[nodiscard]]  std::unique_ptr<Hand> getHand(TextFile& tf, PlayerCache& cache,
-    int level, const Time& date, std::string_view handId) {
-  std::println("Building hand and maxSeats from history file {}.", tf.getFileStem());
-  const auto& [nbMaxSeats, tableName, buttonSeat] { getNbMaxSeatsTableNameButtonSeatFromTableLine(tf) };
-  const auto& seatPlayers { parseSeats(tf, cache) };
-  std::ranges::for_each(seatPlayers, [&cache](const auto & entry) {
-    const auto& [seat, playerName] { entry };
-
-    if (!playerName.empty()) { cache.addIfMissing(playerName); }
+[[nodiscard]] HandParseResult<ArenaPtr<Hand>> getHand(TextFile& tf, PlayerCache& cache, MemoryArena& arena,
+    int level, const Time& date, HandId handId) {
+  logger::trace(LogCategory::parser, "Building hand and maxSeats at line {}.", tf.getLineIndex());
+  const auto table { getNbMaxSeatsTableNameButtonSeatFromTableLine(tf) };
+
+  if (!table.has_value()) { return std::unexpected(table.error()); }
+
+  const auto& [nbMaxSeats, tableName, buttonSeat] { table.value() };
+  const auto seatPlayers { parseSeats(tf, cache) };
+
+  if (!seatPlayers.has_value()) { return std::unexpected(seatPlayers.error()); }
+
+  std::ranges::for_each(seatPlayers.value(), [&cache](PlayerId playerId) {
+    if (PlayerId::none != playerId) { cache.addIfMissing(stringPool::view(playerId)); }
   });
   const auto ante { parseAnte(tf) };
-  const auto& heroCards { parseHeroCards(tf, cache) };
-  auto [actions, winners] { parseActionsAndWinners(tf, handId) };
-  const auto& boardCards { parseBoardCards(tf) };
-  std::println("nb actions={}", actions.size());
+
+  if (!ante.has_value()) { return std::unexpected(ante.error()); }
+
+  const auto heroCards { parseHeroCards(tf, cache) };
+
+  if (!heroCards.has_value()) { return std::unexpected(heroCards.error()); }
+
+  // reused by the hands parsed on this thread, the hand copying its actions into the arena
+  thread_local std::vector<Action> actions;
+  actions.clear();
+  const auto winners { parseActionsAndWinners(tf, seatPlayers.value(), actions) };
+
+  if (!winners.has_value()) { return std::unexpected(winners.error()); }
+
+  const auto boardCards { parseBoardCards(tf) };
+
+  if (!boardCards.has_value()) { return std::unexpected(boardCards.error()); }
+
+  logger::trace(LogCategory::parser, "nb actions={}", actions.size());
   Hand::Params params { .id = handId, .gameType = gameType, .siteName = WINAMAX_SITE_NAME,
                         .tableName = tableName, .buttonSeat = buttonSeat, .maxSeats = nbMaxSeats, .level = level,
-                        .ante = ante, .startDate = date, .seatPlayers = seatPlayers, .heroCards = heroCards,
-                        .boardCards = boardCards, .actions = std::move(actions), .winners = winners };
-  return std::make_unique<Hand>(params);
+                        .ante = ante.value(), .startDate = date, .seatPlayers = seatPlayers.value(),
+                        .heroCards = heroCards.value(), .boardCards = boardCards.value(), .actions = actions,
+                        .winners = winners.value() };
+  return arena.make<Hand>(params);
 }
 
-std::unique_ptr<Hand> WinamaxHandBuilder::buildCashgameHand(TextFile& tf, PlayerCache& pc) {
-  std::println("Building Cashgame from history file {}.", tf.getFileStem());
-  const auto& [_, date, handId] { parseStartOfWinamaxPokerLine(tf.getLine()) };
-  return getHand<GameType::cashGame>(tf, pc, 0, date, handId); // for cashGame, level is zero
+HandParseResult<ArenaPtr<Hand>> WinamaxHandBuilder::buildCashgameHand(TextFile& tf, PlayerCache& pc,
+    MemoryArena& arena) {
+  logger::trace(LogCategory::parser, "Building Cashgame hand at line {}.", tf.getLineIndex());
+  const auto start { parseStartOfWinamaxPokerLine(tf) };
+
+  if (!start.has_value()) { return std::unexpected(start.error()); }
+
+  const auto& [date, handId] { start.value() };
+  return getHand<GameType::cashGame>(tf, pc, arena, 0, date, handId); // for cashGame, level is zero
 }
 
-std::unique_ptr<Hand> WinamaxHandBuilder::buildTournamentHand(TextFile& tf, PlayerCache& pc) {
-  std::println("Building Tournament from history file {}.", tf.getFileStem());
-  const auto& [level, date, handId] { getLevelDateHandIdFromTournamentWinamaxPokerLine(tf.getLine()) };
-  return getHand<GameType::tournament>(tf, pc, level, date, handId);
+HandParseResult<ArenaPtr<Hand>> WinamaxHandBuilder::buildTournamentHand(TextFile& tf, PlayerCache& pc,
+    MemoryArena& arena) {
+  logger::trace(LogCategory::parser, "Building Tournament hand at line {}.", tf.getLineIndex());
+  const auto start { getBuyInLevelDateHandIdFromTournamentWinamaxPokerLine(tf) };
+
+  if (!start.has_value()) { return std::unexpected(start.error()); }
+
+  const auto& [_, level, date, handId] { start.value() };
+  return getHand<GameType::tournament>(tf, pc, arena, level, date, handId);
 }
 
-std::pair<std::unique_ptr<Hand>, std::unique_ptr<GameData>> WinamaxHandBuilder::buildCashgameHandAndGameData(
-      TextFile& tf,
-PlayerCache& pc) {
-  std::println("Building Cashgame and game data from history file {}.",
-                           tf.getFileStem());
-  const auto& [smallBlind, bigBlind, date, handId] { getSmallBlindBigBlindDateHandIdFromCashGameWinamaxPokerLine(tf.getLine()) };
-  auto pHand { getHand<GameType::cashGame>(tf, pc, 0, date, handId) };
-  return { std::move(pHand), std::make_unique<GameData>(GameData::Args{.nbMaxSeats = pHand->getMaxSeats(), .smallBlind = smallBlind, .bigBlind = bigBlind, .buyIn = 0, .startDate = pHand->getStartDate() }) };
+HandParseResult<std::pair<ArenaPtr<Hand>, std::unique_ptr<GameData>>>
+WinamaxHandBuilder::buildCashgameHandAndGameData(TextFile& tf, PlayerCache& pc, MemoryArena& arena) {
+  logger::debug(LogCategory::parser, "Building Cashgame and game data from history file {}.", tf.getFileStem());
+  const auto start { getSmallBlindBigBlindDateHandIdFromCashGameWinamaxPokerLine(tf) };
+
+  if (!start.has_value()) { return std::unexpected(start.error()); }
+
+  const auto& [smallBlind, bigBlind, date, handId] { start.value() };
+  auto pHand { getHand<GameType::cashGame>(tf, pc, arena, 0, date, handId) };
+
+  if (!pHand.has_value()) { return std::unexpected(pHand.error()); }
+
+  auto pGameData { std::make_unique<GameData>(GameData::Args{.nbMaxSeats = pHand.value()->getMaxSeats(), .smallBlind = smallBlind, .bigBlind = bigBlind, .buyIn = {}, .startDate = pHand.value()->getStartDate() }) };
+  return std::pair { std::move(pHand.value()), std::move(pGameData) };
 }
 
-std::pair<std::unique_ptr<Hand>, std::unique_ptr<GameData>> WinamaxHandBuilder::buildTournamentHandAndGameData(
-      TextFile& tf,
-PlayerCache& pc) {
-  std::println("Building Tournament and game data from history file {}.", tf.getFileStem());
-  const auto& [buyIn, level, date, handId] { getBuyInLevelDateHandIdFromTournamentWinamaxPokerLine(tf.getLine()) };
-  auto pHand { getHand<GameType::tournament>(tf, pc, level, date, handId) };
-  return { std::move(pHand), std::make_unique<GameData>(GameData::Args{.nbMaxSeats = pHand->getMaxSeats(), .smallBlind = 0, .bigBlind = 0, .buyIn = buyIn, .startDate = pHand->getStartDate()}) };
+HandParseResult<std::pair<ArenaPtr<Hand>, std::unique_ptr<GameData>>>
+WinamaxHandBuilder::buildTournamentHandAndGameData(TextFile& tf, PlayerCache& pc, MemoryArena& arena) {
+  logger::debug(LogCategory::parser, "Building Tournament and game data from history file {}.", tf.getFileStem());
+  const auto start { getBuyInLevelDateHandIdFromTournamentWinamaxPokerLine(tf) };
+
+  if (!start.has_value()) { return std::unexpected(start.error()); }
+
+  const auto& [buyIn, level, date, handId] { start.value() };
+  auto pHand { getHand<GameType::tournament>(tf, pc, arena, level, date, handId) };
+
+  if (!pHand.has_value()) { return std::unexpected(pHand.error()); }
+
+  auto pGameData { std::make_unique<GameData>(GameData::Args{.nbMaxSeats = pHand.value()->getMaxSeats(), .smallBlind = {}, .bigBlind = {}, .buyIn = buyIn, .startDate = pHand.value()->getStartDate()}) };
+  return std::pair { std::move(pHand.value()), std::move(pGameData) };
 }
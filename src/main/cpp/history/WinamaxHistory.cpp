@@ -1,29 +1,23 @@
 module;
 
-
-#if defined(_MSC_VER) // removal of specific msvc warnings due to stlab
-#  pragma warning(push)
-#  pragma warning(disable : 4355 4868 4996 5204 )
-#endif  // _MSC_VER
-
-#include <stlab/concurrency/utility.hpp> // stlab::blocking_get
-#include <stlab/concurrency/future.hpp> // stlab::async, std::forward
-#include <stlab/concurrency/default_executor.hpp>
-
-#if defined(_MSC_VER)  // end of specific msvc warnings removal
-#  pragma warning(pop)
-#endif  // _MSC_VER
-
 export module history.WinamaxHistory;
 
 import entities.Action;
 import entities.Card;
 import entities.Game;
+import entities.Hand;
+import entities.HandId;
 import entities.Player;
 import entities.Site;
+import history.HandStore;
+import history.HistoryCache;
 import history.WinamaxGameHistory;
 import language.strings;
+import system.ConcurrentMap;
 import system.filesystem;
+import system.Logger;
+import system.OrderedReducer;
+import system.WorkStealingExecutor;
 
 import std;
 
@@ -44,7 +38,10 @@ public:
   ~WinamaxHistory();
   /**
    * @returns a Site containing all the games which history files are located in
-   * the given <historyDir>/history directory.
+   * the given <historyDir>/history directory. The hands found in several files, such as a restored
+   * backup, are loaded once, from the first of these files in the path order.
+   * A load() that is not stopped also writes the hands of the returned Site in the hand store
+   * given by getHandStoreFile().
    */
   [[nodiscard]] std::unique_ptr<Site> load(const std::filesystem::path& historyDir,
       FunctionVoid incrementCb,
@@ -54,11 +51,57 @@ public:
   [[nodiscard]] static std::unique_ptr<Site> importGame(const std::filesystem::path& historyDir);
   std::unique_ptr<Site> importGame(auto) = delete;
 
-  void stopGameImporting();
+  /**
+   * Stops the current load() and waits for it to return. The files being parsed are stopped
+   * between two hands.
+   * @returns the time load() took to stop, or zero if no load() was running.
+   */
+  std::chrono::milliseconds stopGameImporting();
+
+  /**
+   * Sets the number of threads used by load() to parse history files. 0, the default, means one
+   * per hardware thread.
+   */
+  void setNbImportThreads(std::size_t nbThreads) noexcept;
+
+  /**
+   * Sets the directory where the parsed history files are cached by load() and loadFile(). An
+   * empty path disables the cache. By default, the cache is in the cache directory of the user.
+   * The directory should be private to the user, as the cache trusts the files it finds there.
+   */
+  void setCacheDir(const std::filesystem::path& cacheDir);
+  void setCacheDir(auto) = delete;
+
+  /**
+   * @returns the hand store file written by load(), to be opened with HandStore, in the cache
+   * directory, or an empty path if the cache is disabled.
+   */
+  [[nodiscard]] std::filesystem::path getHandStoreFile() const;
 
+  /**
+   * @returns the content of the given history file, read from the cache if the file did not
+   * change since it was cached, or nullptr if the file can't be read.
+   */
+  [[nodiscard]] std::unique_ptr<Site> loadFile(const std::filesystem::path& winamaxHistoryFile) const;
+  std::unique_ptr<Site> loadFile(auto) const = delete;
+
+  /**
+   * Parses again the whole given history file, and remembers where its last complete hand ends
+   * for later calls to refreshFile().
+   */
   [[nodiscard]] std::unique_ptr<Site> reloadFile(const std::filesystem::path& winamaxHistoryFile);
   std::unique_ptr<Site> reloadFile(auto) = delete;
 
+  /**
+   * Parses only the hands appended to the given history file since the last call to reloadFile()
+   * or refreshFile() for that file, and adds them to the matching game of the given site.
+   * The cost depends on the size of the appended data, not on the size of the file. Different
+   * files can be refreshed concurrently.
+   * @returns the number of new hands.
+   */
+  std::size_t refreshFile(const std::filesystem::path& winamaxHistoryFile, Site& site);
+  std::size_t refreshFile(auto, Site&) = delete;
+
   [[nodiscard]] static bool isValidHistoryDir(const std::filesystem::path& historyDir);
   static bool isValidHistoryDir(auto) = delete;
 
@@ -80,8 +123,36 @@ public:
 module : private;
 
 struct [[nodiscard]] WinamaxHistory::Implementation final {
-  std::vector<stlab::future<Site*>> m_tasks {};
-  std::atomic_bool m_stop { true };
+  std::mutex m_loadMutex {}; // held during load()
+  std::mutex m_stopMutex {};
+  std::stop_source m_stopSource { std::nostopstate }; // has a stop state only during load()
+  std::size_t m_nbImportThreads { 0 };
+  std::mutex m_tailsMutex {};
+  std::unordered_map<std::string, HistoryFileTail> m_tails {}; // the key is the history file path
+  std::filesystem::path m_cacheDir { getDefaultCacheDir() }; // empty: no cache
+
+  // the cache of the user, never a shared directory such as the temporary one
+  [[nodiscard]] static std::filesystem::path getDefaultCacheDir() {
+    const auto& userCacheDir { prm::system::filesystem::getUserCacheDir() };
+    return userCacheDir.empty() ? userCacheDir : userCacheDir / "prm" / "history";
+  }
+
+  [[nodiscard]] std::stop_token startImport() {
+    const std::lock_guard lock { m_stopMutex };
+    m_stopSource = std::stop_source();
+    return m_stopSource.get_token();
+  }
+
+  void endImport() {
+    const std::lock_guard lock { m_stopMutex };
+    m_stopSource = std::stop_source(std::nostopstate);
+  }
+
+  // returns true if an import was running and not yet stopped
+  [[nodiscard]] bool requestStop() {
+    const std::lock_guard lock { m_stopMutex };
+    return m_stopSource.request_stop();
+  }
 }; // struct WinamaxHistory::Implementation
 
 WinamaxHistory::WinamaxHistory() noexcept : m_pImpl { std::make_unique<Implementation>() }  {}
@@ -173,96 +244,288 @@ bool WinamaxHistory::isValidHistoryFile(const std::filesystem::path& historyFile
 }
 std::vector<std::filesystem::path> getFilesAndNotify(auto, auto) = delete;
 
-std::vector<stlab::future<Site*>> parseFilesAsync(std::span<const std::filesystem::path> files,
-std::atomic_bool& stop, const auto& incrementCb) {
-  std::vector<stlab::future<Site*>> ret;
-  ret.reserve(files.size());
-  std::transform(std::begin(files), std::end(files), std::back_inserter(ret), [&incrementCb,
-  &stop](const auto & file) {
-    if (!stop) {
-      return stlab::async(stlab::default_executor, [&file, &incrementCb, &stop]() {
-        Site* pSite { nullptr };
-
-        try {
-          if (!stop) { pSite = WinamaxGameHistory::parseGameHistory(file).release(); }
-        } catch (const std::exception& e) {
-          std::println(std::cerr, "Exception loading the file {}: {}", file.filename().string(), e.what());
-        } catch (const char* str) {
-          std::println(std::cerr, "Exception loading the file {}: {}", file.filename().string(), str);
-        }
-
-        if (!stop and incrementCb) { incrementCb(); }
-
-        return pSite;
-      });
-    } else { return stlab::future<Site*>(); }
+[[nodiscard]] std::unique_ptr<Site> loadFromCacheOrParse(const std::filesystem::path& file,
+    const HistoryCache& cache, std::stop_token stopToken, std::size_t nbThreads) {
+  if (auto pSite { cache.load(file) }; nullptr != pSite) { return pSite; }
+
+  auto ret { WinamaxGameHistory::parseGameHistory(file, stopToken, nbThreads) };
+
+  // a stopped parsing gives an incomplete site
+  if (!stopToken.stop_requested()) { cache.store(file, *ret); }
+
+  return ret;
+}
+
+// the biggest files are parsed first, so that none of them is started last and delays the import end
+// @returns the indexes of files, from the biggest file to the smallest one
+[[nodiscard]] static std::vector<std::size_t> getIndexesLargestFirst(std::span<const std::filesystem::path> files) {
+  std::vector<std::uintmax_t> sizes;
+  sizes.reserve(files.size());
+  std::ranges::transform(files, std::back_inserter(sizes), [](const auto & file) {
+    std::error_code ec;
+    const auto size { std::filesystem::file_size(file, ec) };
+    return ec ? 0 : size;
   });
+  std::vector<std::size_t> ret(files.size());
+  std::iota(ret.begin(), ret.end(), std::size_t { 0 });
+  std::ranges::stable_sort(ret, std::greater {}, [&sizes](std::size_t i) { return sizes[i]; });
   return ret;
 }
 
+[[nodiscard]] static std::unique_ptr<Site> parseFile(const std::filesystem::path& file, const HistoryCache& cache,
+    std::stop_token stopToken, std::size_t nbThreads) {
+  try {
+    return loadFromCacheOrParse(file, cache, stopToken, nbThreads);
+  } catch (const std::exception& e) {
+    logger::error(LogCategory::import, "Exception loading the file {}: {}", file.filename().string(), e.what());
+  } catch (const char* str) {
+    logger::error(LogCategory::import, "Exception loading the file {}: {}", file.filename().string(), str);
+  }
+
+  return nullptr;
+}
+
 constexpr std::string_view WINAMAX_SITE_NAME = "Winamax";
 
-std::unique_ptr<Site> WinamaxHistory::load(const std::filesystem::path& winamaxHistoryDir,
-    FunctionVoid incrementCb,
-    FunctionInt setNbFilesCb) {
-  m_pImpl->m_stop = false;
+// the parsed sites waiting to be merged, or being parsed, are at most this number per thread, so that
+// the memory held does not depend on the number of files
+constexpr std::size_t MAX_NB_PENDING_FILES_PER_THREAD { 4 };
+
+// the hands found in several files of a load(), such as a restored backup, are kept from the first
+// of these files in the path order, whatever the order the jobs run in
+struct [[nodiscard]] LoadedHands final {
+  std::vector<std::vector<HandId>> handIds {}; // indexed as the files, read before any parsing
+  ConcurrentMap<HandId, std::size_t> owners {}; // the index of the first file having the hand
+  std::atomic_size_t nbDuplicatedHands { 0 };
+  std::atomic_size_t nbDuplicatedFiles { 0 };
+};
+
+// the ids are read from the hand start lines, so that the owner of each hand is known before the
+// files are parsed
+static void addOwners(std::span<const std::filesystem::path> files, std::span<const std::size_t> fileIndexes,
+                      LoadedHands& loaded, std::size_t nbThreads, std::stop_token stopToken) {
+  loaded.handIds.resize(files.size());
+  std::vector<std::function<void()>> jobs;
+  jobs.reserve(files.size());
+  std::ranges::transform(fileIndexes, std::back_inserter(jobs), [&](std::size_t i) {
+    return [&file = files[i], &loaded, &stopToken, i]() {
+      if (stopToken.stop_requested()) { return; }
+
+      loaded.handIds[i] = WinamaxGameHistory::getHandIds(file);
+      std::ranges::for_each(loaded.handIds[i], [&loaded, i](HandId id) {
+        loaded.owners.insertOrCombine(id, i, [](std::size_t a, std::size_t b) { return std::min(a, b); });
+      });
+    };
+  });
+  WorkStealingExecutor executor { std::move(jobs), nbThreads };
+  executor.wait();
+}
+
+// @returns the site of the file of the given index without the hands of a previous file, or
+// nullptr if all its hands are in previous files, such a copy being not parsed at all
+[[nodiscard]] static std::unique_ptr<Site> parseOwnedHands(const std::filesystem::path& file, std::size_t fileIndex,
+    LoadedHands& loaded, const HistoryCache& cache, std::stop_token stopToken, std::size_t nbThreads) {
+  const auto isOwned { [&loaded, fileIndex](HandId id) {
+    const auto oOwner { loaded.owners.find(id) };
+    return !oOwner.has_value() or fileIndex == oOwner.value();
+  } };
+  const auto& ids { loaded.handIds[fileIndex] };
+  const auto nbOwnedHands { static_cast<std::size_t>(std::ranges::count_if(ids, isOwned)) };
+
+  if (!ids.empty() and 0 == nbOwnedHands) {
+    loaded.nbDuplicatedHands += ids.size();
+    ++loaded.nbDuplicatedFiles;
+    return nullptr;
+  }
 
+  auto ret { parseFile(file, cache, stopToken, nbThreads) };
+
+  if (nullptr != ret and nbOwnedHands < ids.size()) {
+    loaded.nbDuplicatedHands += ret->removeHandsIf([&isOwned](const Hand & hand) { return !isOwned(hand.getId()); });
+  }
+
+  return ret;
+}
+
+[[nodiscard]] static std::unique_ptr<Site> loadFiles(const std::filesystem::path& winamaxHistoryDir,
+    const FunctionVoid& incrementCb, const FunctionInt& setNbFilesCb, const HistoryCache& cache,
+    std::size_t nbThreads, std::stop_token stopToken) {
   try {
-    const auto& files { getFilesAndNotify(winamaxHistoryDir, setNbFilesCb) };
+    auto files { getFilesAndNotify(winamaxHistoryDir, setNbFilesCb) };
     auto ret { std::make_unique<Site>(WINAMAX_SITE_NAME) };
 
     if (files.empty()) {
       return ret;
     }
 
-    m_pImpl->m_tasks = parseFilesAsync(files, m_pImpl->m_stop, incrementCb);
-    std::ranges::for_each(m_pImpl->m_tasks, [&ret, this](auto & task) {
-      if (task.valid()) {
-        std::unique_ptr<Site> s { stlab::blocking_get(task) };
+    // the sites are merged in the order of the file paths, whatever the order the jobs end in, so
+    // that the games of the site are in the same order from one load to the next
+    std::ranges::sort(files);
+    // with less files than workers, the threads of the missing workers help to parse the big files
+    const auto nbThreadsPerFile { std::max<std::size_t>(1, WorkStealingExecutor::toNbWorkers(nbThreads) / files.size()) };
+    // the site of a file is merged by its job with the sites of the neighbouring files already parsed
+    const auto mergeSites { [](std::unique_ptr<Site>& pLeft, std::unique_ptr<Site>&& pRight) {
+      if (nullptr == pLeft) {
+        pLeft = std::move(pRight);
+      } else if (nullptr != pRight) {
+        pLeft->merge(*pRight);
+      }
+    } };
+    const auto fileIndexes { getIndexesLargestFirst(files) };
+    // the jobs take the files to parse from parsedSites, which bounds the number of sites parsed and
+    // not yet merged into the site of the first file
+    OrderedReducer<std::unique_ptr<Site>, decltype(mergeSites)> parsedSites { fileIndexes, mergeSites,
+        MAX_NB_PENDING_FILES_PER_THREAD * WorkStealingExecutor::toNbWorkers(nbThreads) }; // indexed as files
+    LoadedHands loaded;
+    addOwners(files, fileIndexes, loaded, nbThreads, stopToken);
+    // each job parses the file it claims, the jobs being all the same
+    const std::function<void()> job { [&files, &parsedSites, &cache, &loaded, &stopToken, &incrementCb, nbThreadsPerFile]() {
+      const auto i { parsedSites.claim() };
+      const auto& file { files[i] };
+      std::unique_ptr<Site> pSite;
+
+      // a failing file, or a failing progress callback, does not stop the other files
+      try {
+        if (!stopToken.stop_requested()) { pSite = parseOwnedHands(file, i, loaded, cache, stopToken, nbThreadsPerFile); }
+
+        if (!stopToken.stop_requested() and incrementCb) { incrementCb(); }
+      } catch (const std::exception& e) {
+        logger::error(LogCategory::import, "Exception loading the file {}: {}", file.filename().string(), e.what());
+      }
+
+      // every file gives a site, even an empty one, for the merge to end
+      parsedSites.set(i, std::move(pSite));
+    } };
+    WorkStealingExecutor executor { std::vector(files.size(), job), nbThreads };
+    executor.wait();
+
+    if (!stopToken.stop_requested()) {
+      if (const auto pSite { parsedSites.take() }; nullptr != pSite) { ret->merge(*pSite); }
 
-        if (!m_pImpl->m_stop and s) { ret->merge(*s); }
+      if (0 < loaded.nbDuplicatedHands) {
+        logger::info(LogCategory::import, "{} duplicated hands dropped, {} files having only such hands not parsed",
+                     loaded.nbDuplicatedHands.load(), loaded.nbDuplicatedFiles.load());
       }
-    });
-    m_pImpl->m_tasks.clear();
+    }
+
     return ret;
   } catch (const std::exception& e) {
-    std::println(std::cerr, "Exception au chargement de {} : {}", winamaxHistoryDir.string(), e.what());
+    logger::error(LogCategory::import, "Exception au chargement de {} : {}", winamaxHistoryDir.string(), e.what());
     return std::make_unique<Site>(WINAMAX_SITE_NAME);
   }
 }
 
+static void writeHandStore(const Site& site, const std::filesystem::path& handStoreFile) {
+  try {
+    std::error_code ec;
+
+    // like the cache directory, a new directory is private to the user
+    if (std::filesystem::create_directories(handStoreFile.parent_path(), ec)) {
+      std::filesystem::permissions(handStoreFile.parent_path(), std::filesystem::perms::owner_all, ec);
+    }
+
+    handStore::write(site, handStoreFile);
+  } catch (const std::exception& e) {
+    logger::error(LogCategory::import, "Can't write the hand store {}: {}", handStoreFile.string(), e.what());
+  }
+}
+
+std::unique_ptr<Site> WinamaxHistory::load(const std::filesystem::path& winamaxHistoryDir,
+    FunctionVoid incrementCb,
+    FunctionInt setNbFilesCb) {
+  const std::lock_guard loading { m_pImpl->m_loadMutex };
+  const auto stopToken { m_pImpl->startImport() };
+  auto ret { loadFiles(winamaxHistoryDir, incrementCb, setNbFilesCb, HistoryCache { m_pImpl->m_cacheDir },
+                       WorkStealingExecutor::toNbWorkers(m_pImpl->m_nbImportThreads), stopToken) };
+
+  // a stopped load gives an incomplete site
+  if (const auto & handStoreFile { getHandStoreFile() }; !handStoreFile.empty() and !stopToken.stop_requested()) {
+    writeHandStore(*ret, handStoreFile);
+  }
+
+  m_pImpl->endImport();
+  return ret;
+}
+
 /* [[nodicard]] static */ std::unique_ptr<Site> WinamaxHistory::importGame(
   const std::filesystem::path& historyDir) {
   WinamaxHistory wh;
   return wh.load(historyDir, nullptr, nullptr);
 }
 
-void WinamaxHistory::stopGameImporting() {
-  m_pImpl->m_stop = true;
-  std::size_t nbTasksFinished { 0 };
+std::chrono::milliseconds WinamaxHistory::stopGameImporting() {
+  const auto start { std::chrono::steady_clock::now() };
 
-  while (nbTasksFinished != m_pImpl->m_tasks.size()) {
-    std::ranges::for_each(m_pImpl->m_tasks, [&nbTasksFinished](auto & task) {
-      if (task.is_ready()) {
-        task.reset(); // it won't be ready anymore
-        nbTasksFinished++;
-      }
-    });
-  }
+  if (!m_pImpl->requestStop()) { return std::chrono::milliseconds::zero(); }
+
+  // blocks until load() returns, as load() holds this mutex
+  const std::lock_guard waitForLoad { m_pImpl->m_loadMutex };
+  const auto ret { std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start) };
+  logger::info(LogCategory::import, "Import stopped in {} ms.", ret.count());
+  return ret;
+}
+
+void WinamaxHistory::setNbImportThreads(std::size_t nbThreads) noexcept { m_pImpl->m_nbImportThreads = nbThreads; }
+
+void WinamaxHistory::setCacheDir(const std::filesystem::path& cacheDir) { m_pImpl->m_cacheDir = cacheDir; }
+
+std::filesystem::path WinamaxHistory::getHandStoreFile() const {
+  return m_pImpl->m_cacheDir.empty() ? std::filesystem::path {} : m_pImpl->m_cacheDir / "hands.prmh";
+}
+
+std::unique_ptr<Site> WinamaxHistory::loadFile(const std::filesystem::path& file) const {
+  return parseFile(file, HistoryCache { m_pImpl->m_cacheDir }, {}, 0);
 }
 
 std::unique_ptr<Site> WinamaxHistory::reloadFile(const std::filesystem::path& file) {
   std::unique_ptr<Site> ret { nullptr };
 
   try {
-    ret = WinamaxGameHistory::parseGameHistory(file);
+    HistoryFileTail tail {};
+    ret = WinamaxGameHistory::parseGameHistory(file, tail);
+    const std::lock_guard lock { m_pImpl->m_tailsMutex };
+    m_pImpl->m_tails.insert_or_assign(file.string(), tail);
   } catch (const std::exception& e) {
-    std::println(std::cerr, "Exception loading the file {}: {}", file.string(), e.what());
+    logger::error(LogCategory::import, "Exception loading the file {}: {}", file.string(), e.what());
   }
 
   return ret;
 }
 
+std::size_t WinamaxHistory::refreshFile(const std::filesystem::path& file, Site& site) {
+  const auto& key { file.string() };
+  HistoryFileTail tail {};
+  {
+    // the lock is not held during the parsing, so that the other files can be refreshed meanwhile
+    const std::lock_guard lock { m_pImpl->m_tailsMutex };
+    tail = m_pImpl->m_tails[key];
+  }
+  const auto parsedSizeBefore { tail.parsedSize };
+  const auto nbHandsBefore { tail.nbHands };
+  std::size_t nbDuplicatedHands { 0 };
+
+  try {
+    auto pNewHands { WinamaxGameHistory::parseGameHistory(file, tail) };
+    {
+      const std::lock_guard lock { m_pImpl->m_tailsMutex };
+      auto& storedTail { m_pImpl->m_tails[key] };
+
+      // a concurrent refresh of this file already gave these hands
+      if (parsedSizeBefore != storedTail.parsedSize) { return 0; }
+
+      storedTail = tail;
+    }
+
+    if (nbDuplicatedHands = site.mergeHands(*pNewHands); 0 < nbDuplicatedHands) {
+      logger::debug(LogCategory::import, "{} hands of the file {} were already known", nbDuplicatedHands, file.string());
+    }
+  } catch (const std::exception& e) {
+    logger::error(LogCategory::import, "Exception refreshing the file {}: {}", file.string(), e.what());
+  }
+
+  return tail.nbHands - nbHandsBefore - nbDuplicatedHands;
+}
+
 [[nodiscard]] inline bool notFound(std::string_view::size_type st) { return std::string_view::npos == st; }
 
 std::string_view WinamaxHistory::getTableNameFromTableWindowTitle(std::string_view tableWindowTitle)
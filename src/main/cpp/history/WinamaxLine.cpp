@@ -0,0 +1,271 @@
+module;
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && 2 <= _M_IX86_FP)
+#  define PRM_SSE2
+#  include <emmintrin.h> // _mm_*
+#endif
+
+export module history.WinamaxLine;
+
+import entities.Action; // ActionType, Street
+
+#pragma warning( push )
+#pragma warning( disable : 4686)
+import std;
+#pragma warning( pop )
+
+/**
+ * The kinds of lines of a Winamax hand that the hand builder reads.
+ */
+export enum class /*[[nodiscard]]*/ WinamaxLineKind : short {
+  other, empty, handStart, street, seat, postsAnte, postsBlind, dealtTo, action, shows, collected, board
+};
+
+/**
+ * A line of a Winamax history file, with the views on its fields. The fields that the line kind
+ * does not have are empty.
+ */
+export struct [[nodiscard]] WinamaxLine final {
+  WinamaxLineKind kind { WinamaxLineKind::other };
+  Street street { Street::none }; // for a street line, none for "*** ANTE/BLINDS ***" and "*** SUMMARY ***"
+  ActionType actionType { ActionType::none }; // for an action line
+  std::string_view playerName {}; // for the seat, posts, dealtTo, action, shows and collected lines
+  std::string_view seatNumber {}; // for a seat line
+  std::string_view amount {}; // the amount posted, bet, raised to, called or collected
+  std::string_view cards {}; // "[4c 3s]", for the dealtTo, shows and board lines
+};
+
+export namespace winamaxLine {
+/**
+ * Classifies the line in a single pass: the lines with a fixed start are recognized by their first
+ * byte, the player lines by the keyword following one of their spaces, the spaces being found 16
+ * bytes at a time when SSE2 is available.
+ * A player name containing one of the keywords, such as " calls ", is cut before it.
+ */
+[[nodiscard]] WinamaxLine classify(std::string_view line) noexcept;
+
+/**
+ * classify() without SIMD, which the SIMD scan must agree with.
+ */
+[[nodiscard]] WinamaxLine classifyScalar(std::string_view line) noexcept;
+} // namespace winamaxLine
+
+module : private;
+
+// the lines starting with these are not player lines
+static constexpr std::string_view WINAMAX_POKER { "Winamax Poker - " };
+static constexpr std::string_view DEALT_TO { "Dealt to " };
+static constexpr std::string_view BOARD { "Board: " };
+static constexpr std::string_view SEAT { "Seat " };
+static constexpr std::string_view STREET_START { "*** " };
+
+[[nodiscard]] static constexpr std::string_view afterLastSpace(std::string_view line) noexcept {
+  return line.substr(line.rfind(' ') + 1);
+}
+
+[[nodiscard]] static constexpr std::string_view toCards(std::string_view line) noexcept {
+  const auto pos { line.rfind('[') };
+  return std::string_view::npos == pos ? std::string_view {} : line.substr(pos);
+}
+
+[[nodiscard]] static constexpr WinamaxLine toStreetLine(std::string_view line) noexcept {
+  constexpr std::array<std::pair<std::string_view, Street>, 5> STREETS { {
+      { "*** PRE-FLOP ***", Street::preflop }, { "*** FLOP ***", Street::flop }, { "*** TURN ***", Street::turn },
+      { "*** RIVER ***", Street::river }, { "*** SHOW DOWN ***", Street::river }
+    }
+  };
+  const auto it { std::ranges::find_if(STREETS, [line](const auto & entry) { return line.starts_with(entry.first); }) };
+  return { .kind = WinamaxLineKind::street, .street = STREETS.end() == it ? Street::none : it->second };
+}
+
+// "Seat 1: HusKKy (2.11€)", or "Seat 5: SR.Varianza won 0.22€" in the summary
+[[nodiscard]] static constexpr WinamaxLine toSeatLine(std::string_view line) noexcept {
+  const auto pos { line.find(": ", SEAT.size()) };
+
+  if (std::string_view::npos == pos) { return {}; }
+
+  const auto nameEnd { line.rfind(" (") };
+  return { .kind = WinamaxLineKind::seat,
+           .playerName = line.substr(pos + 2, std::string_view::npos == nameEnd or nameEnd < pos ? std::string_view::npos : nameEnd - pos - 2),
+           .seatNumber = line.substr(SEAT.size(), pos - SEAT.size()) };
+}
+
+// the lines starting with a fixed text, std::nullopt for a player line
+[[nodiscard]] static constexpr std::optional<WinamaxLine> classifyByStart(std::string_view line) noexcept {
+  switch (line.front()) {
+    case '*':
+      if (line.starts_with(STREET_START)) { return toStreetLine(line); }
+
+      break;
+
+    case 'B':
+      if (line.starts_with(BOARD)) { return WinamaxLine { .kind = WinamaxLineKind::board, .cards = toCards(line) }; }
+
+      break;
+
+    case 'D':
+      if (line.starts_with(DEALT_TO)) {
+        const auto nameEnd { line.rfind(" [") };
+        return WinamaxLine { .kind = WinamaxLineKind::dealtTo,
+                             .playerName = line.substr(DEALT_TO.size(), std::string_view::npos == nameEnd ? nameEnd : nameEnd - DEALT_TO.size()),
+                             .cards = toCards(line) };
+      }
+
+      break;
+
+    case 'W':
+      if (line.starts_with(WINAMAX_POKER)) { return WinamaxLine { .kind = WinamaxLineKind::handStart }; }
+
+      break;
+
+    case 'S':
+      if (line.starts_with(SEAT) and SEAT.size() < line.size() and '0' <= line[SEAT.size()] and line[SEAT.size()] <= '9') {
+        return toSeatLine(line);
+      }
+
+      break;
+
+    default: break;
+  }
+
+  return {};
+}
+
+// the player line whose keyword follows the space at spacePos, if any
+[[nodiscard]] static constexpr std::optional<WinamaxLine> classifyAtSpace(std::string_view line,
+    std::size_t spacePos) noexcept {
+  const auto rest { line.substr(spacePos) };
+  const auto name { line.substr(0, spacePos) };
+  const auto toAction { [&](ActionType type, std::string_view amount) {
+    return WinamaxLine { .kind = WinamaxLineKind::action, .actionType = type, .playerName = name, .amount = amount };
+  } };
+
+  if (rest.size() < 2) { return {}; }
+
+  switch (rest[1]) {
+    case 'f':
+      if (" folds" == rest) { return toAction(ActionType::fold, {}); }
+
+      break;
+
+    case 'c':
+      if (" checks" == rest) { return toAction(ActionType::check, {}); }
+
+      if (rest.starts_with(" calls ")) { return toAction(ActionType::call, afterLastSpace(rest)); }
+
+      if (rest.starts_with(" collected ")) {
+        constexpr std::string_view COLLECTED { " collected " };
+        const auto amount { rest.substr(COLLECTED.size()) };
+        return WinamaxLine { .kind = WinamaxLineKind::collected, .playerName = name, .amount = amount.substr(0, amount.find(' ')) };
+      }
+
+      break;
+
+    case 'b':
+      if (rest.starts_with(" bets ")) { return toAction(ActionType::bet, afterLastSpace(rest)); }
+
+      break;
+
+    case 'r':
+      if (rest.starts_with(" raises ")) { return toAction(ActionType::raise, afterLastSpace(rest)); }
+
+      break;
+
+    case 's':
+      if (rest.starts_with(" shows ")) {
+        return WinamaxLine { .kind = WinamaxLineKind::shows, .playerName = name, .cards = toCards(rest) };
+      }
+
+      break;
+
+    case 'p':
+      if (rest.starts_with(" posts ante ")) {
+        constexpr std::string_view POSTS_ANTE { " posts ante " };
+        return WinamaxLine { .kind = WinamaxLineKind::postsAnte, .playerName = name, .amount = rest.substr(POSTS_ANTE.size()) };
+      }
+
+      if (rest.starts_with(" posts ")) {
+        return WinamaxLine { .kind = WinamaxLineKind::postsBlind, .playerName = name, .amount = afterLastSpace(rest) };
+      }
+
+      break;
+
+    default: break;
+  }
+
+  return {};
+}
+
+[[nodiscard]] static constexpr WinamaxLine classifyByScalarScan(std::string_view line) noexcept {
+  for (auto pos { line.find(' ', 1) }; std::string_view::npos != pos; pos = line.find(' ', pos + 1)) {
+    if (const auto oLine { classifyAtSpace(line, pos) }; oLine.has_value()) { return oLine.value(); }
+  }
+
+  return {};
+}
+
+#if defined(PRM_SSE2)
+[[nodiscard]] static WinamaxLine classifyBySse2Scan(std::string_view line) noexcept {
+  const auto spaces { _mm_set1_epi8(' ') };
+  std::size_t chunkStart { 0 };
+
+  for (; chunkStart + 16 <= line.size(); chunkStart += 16) {
+    const auto chunk { _mm_loadu_si128(reinterpret_cast<const __m128i*>(line.data() + chunkStart)) };
+
+    for (auto mask { static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, spaces))) }; 0 != mask;
+         mask &= mask - 1) {
+      if (const auto pos { chunkStart + static_cast<std::size_t>(std::countr_zero(mask)) }; 0 < pos) {
+        if (const auto oLine { classifyAtSpace(line, pos) }; oLine.has_value()) { return oLine.value(); }
+      }
+    }
+  }
+
+  // the end of the line, shorter than a chunk
+  for (auto pos { line.find(' ', std::max<std::size_t>(1, chunkStart)) }; std::string_view::npos != pos;
+       pos = line.find(' ', pos + 1)) {
+    if (const auto oLine { classifyAtSpace(line, pos) }; oLine.has_value()) { return oLine.value(); }
+  }
+
+  return {};
+}
+#endif // PRM_SSE2
+
+// classify() without SIMD, usable at compile time
+[[nodiscard]] static constexpr WinamaxLine constexprClassify(std::string_view line) noexcept {
+  if (line.empty()) { return { .kind = WinamaxLineKind::empty }; }
+
+  if (const auto oLine { classifyByStart(line) }; oLine.has_value()) { return oLine.value(); }
+
+  return classifyByScalarScan(line);
+}
+
+WinamaxLine winamaxLine::classify(std::string_view line) noexcept {
+#if defined(PRM_SSE2)
+
+  if (line.empty()) { return { .kind = WinamaxLineKind::empty }; }
+
+  if (const auto oLine { classifyByStart(line) }; oLine.has_value()) { return oLine.value(); }
+
+  return classifyBySse2Scan(line);
+#else
+  return constexprClassify(line);
+#endif // PRM_SSE2
+}
+
+WinamaxLine winamaxLine::classifyScalar(std::string_view line) noexcept { return constexprClassify(line); }
+
+static_assert(WinamaxLineKind::empty == constexprClassify("").kind);
+static_assert(Street::flop == constexprClassify("*** FLOP *** [5d Kh 3d]").street);
+static_assert(Street::none == constexprClassify("*** ANTE/BLINDS ***").street);
+static_assert("Mr Shelbi" == constexprClassify("Seat 6: Mr Shelbi (2.39€)").playerName);
+static_assert("6" == constexprClassify("Seat 6: Mr Shelbi (2.39€)").seatNumber);
+static_assert("sabre_laser" == constexprClassify("Dealt to sabre_laser [4c 3s]").playerName);
+static_assert("[5d Kh 3d]" == constexprClassify("Board: [5d Kh 3d]").cards);
+static_assert(ActionType::fold == constexprClassify("Mr Shelbi folds").actionType);
+static_assert("Mr Shelbi" == constexprClassify("Mr Shelbi calls 0.06€").playerName);
+static_assert("0.06€" == constexprClassify("SR.Varianza raises 0.04€ to 0.06€").amount);
+static_assert("0.22€" == constexprClassify("SR.Varianza collected 0.22€ from pot").amount);
+static_assert(WinamaxLineKind::postsBlind == constexprClassify("HusKKy posts small blind 0.01€").kind);
+static_assert("50" == constexprClassify("HusKKy posts ante 50").amount);
+static_assert(WinamaxLineKind::handStart == constexprClassify("Winamax Poker - Go Fast \"Colorado\" - HandId: #1-2-3").kind);
+static_assert(WinamaxLineKind::other == constexprClassify("Total pot 0.22€ | Rake 0.01€").kind);
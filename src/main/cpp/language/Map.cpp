@@ -9,20 +9,60 @@ export namespace language {
  * This is a compile-time map. Use it as a constexpr variable.
  * The number of elements must be provided beside the elements themselves at the
  * Map instanciation.
+ * The elements are sorted by key when the map is built, and a duplicated key fails the build.
+ * When the keys are enum or integer values without holes, at() indexes the elements directly,
+ * otherwise it does a binary search.
  */
 template <typename K, typename V, std::size_t Size>
-struct Map {
+class Map {
+private:
   std::array<std::pair<K, V>, Size> m_data;
+  bool m_isDense { false };
+
+  static constexpr bool HAS_INTEGRAL_KEYS { std::is_enum_v<K> or std::is_integral_v<K> };
+
+  [[nodiscard]] static constexpr long long toInteger(const K& key) noexcept requires HAS_INTEGRAL_KEYS {
+    if constexpr (std::is_enum_v<K>) { return static_cast<long long>(std::to_underlying(key)); }
+    else { return static_cast<long long>(key); }
+  }
+
+  [[noreturn]] static void throwKeyNotFound() { throw std::range_error("Key Not Found in Map"); }
+
+public:
+  constexpr Map(const std::array<std::pair<K, V>, Size>& data) : m_data { data } {
+    std::ranges::sort(m_data, {}, &std::pair<K, V>::first);
+
+    if (m_data.end() != std::ranges::adjacent_find(m_data, {}, &std::pair<K, V>::first)) {
+      throw std::invalid_argument("Duplicated key in Map");
+    }
+
+    if constexpr (HAS_INTEGRAL_KEYS and 0 < Size) {
+      m_isDense = Size - 1 == static_cast<std::size_t>(toInteger(m_data.back().first) - toInteger(m_data.front().first));
+    }
+  }
 
   [[nodiscard]] constexpr V at(const K& key) const {
-    const auto itr { std::find_if(begin(m_data), end(m_data), [&key](const auto& v) { return v.first == key; }) };
-    return (itr == end(m_data)) ? throw std::range_error("Key Not Found in Map") : itr->second;
+    if constexpr (HAS_INTEGRAL_KEYS and 0 < Size) {
+      if (m_isDense) {
+        const auto index { toInteger(key) - toInteger(m_data.front().first) };
+
+        if (0 > index or std::cmp_less_equal(Size, index)) { throwKeyNotFound(); }
+
+        return m_data[static_cast<std::size_t>(index)].second;
+      }
+    }
+
+    const auto itr { std::ranges::lower_bound(m_data, key, {}, &std::pair<K, V>::first) };
+
+    if (m_data.end() == itr or key != itr->first) { throwKeyNotFound(); }
+
+    return itr->second;
   }
-}; // struct Map
+}; // class Map
 
 template<typename K, typename V, typename ... Args>
 [[nodiscard]] constexpr Map< K, V, sizeof...(Args)> makeMap(Args&& ...args) {
-  return { { std::forward<Args>(args)... } };
+  return Map< K, V, sizeof...(Args)> { { std::pair<K, V>(std::forward<Args>(args))... } };
 }
 
-} // export namespace language
\ No newline at end of file
+} // export namespace language
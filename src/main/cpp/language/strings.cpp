@@ -34,10 +34,6 @@ template <typename CHAR, std::size_t SIZE>
   return std::string_view::npos != s.find(searched, position);
 }
 
-[[nodiscard]] double toBuyIn(std::string_view buyIn);
-
-[[nodiscard]] double toAmount(std::string_view amount);
-
 [[nodiscard]] int toInt(std::string_view numberStr);
 
 [[nodiscard]] std::size_t toSizeT(std::string_view numberStr);
@@ -45,92 +41,198 @@ template <typename CHAR, std::size_t SIZE>
 [[nodiscard]] std::vector<std::string> split(std::string_view toBeSplitted, const char delimiter);
 
 [[nodiscard]] std::string join(const std::vector<std::string>& toBeJoined, const char delimiter);
-} // namespace language::strings
-
-module : private;
-
-[[nodiscard]]  std::string_view language::strings::myTrim(std::string_view s) {
-  s.remove_prefix(gsl::narrow_cast<std::string_view::size_type>(std::distance(s.cbegin(),
-                  std::find_if_not(s.cbegin(), s.cend(), isSpace))));
-  s.remove_suffix(gsl::narrow_cast<std::string_view::size_type>(std::distance(s.crbegin(),
-                  std::find_if_not(s.crbegin(), s.crend(), isSpace))));
-  return s;
-}
-
-[[nodiscard]] std::string language::strings::sanitize(std::string_view toBeSanitized) {
-  std::string ret { myTrim(toBeSanitized) };
-  std::ranges::replace(ret, '\'', '-');
-  return ret;
-}
-
-[[nodiscard]] double toDouble(std::string_view amount) {
-  const auto str { language::strings::myTrim(amount) };
-  double ret { 0 };
-#if defined(_MSC_VER) // std::from_chars is not available for double on gcc 11.2.0 TODO est-ce tjrs d'actualite
-  std::from_chars(str.data(), str.data() + amount.size(), ret);
-#else
-#include <stdio.h>
-
-  try { ret = std::stod(String(str)); }
-  catch (const std::invalid_argument&) { return 0.0; } // silent error
-
-#endif
-  return ret;
-}
-
-[[nodiscard]] double language::strings::toBuyIn(std::string_view buyIn) {
-  std::string token;
-  token.reserve(buyIn.size());
-  double ret { 0.0 };
-  std::ranges::for_each(buyIn, [&token, &ret](auto c) {
-    switch (c) {
-      case ',': { token += '.'; } break;
-
-      case '.': [[fallthrough]];
 
-      case '0': [[fallthrough]];
+/**
+ * A string literal usable as a template argument, such as the text of a LinePattern.
+ */
+template<std::size_t SIZE>
+struct [[nodiscard]] FixedString final {
+  std::array<char, SIZE> chars {};
 
-      case '1': [[fallthrough]];
+  consteval FixedString(const char(&s)[SIZE]) noexcept { std::ranges::copy(s, chars.begin()); }
 
-      case '2': [[fallthrough]];
+  [[nodiscard]] constexpr std::string_view view() const noexcept { return { chars.data(), SIZE - 1 }; }
+};
 
-      case '3': [[fallthrough]];
+/**
+ * A line pattern compiled at build time from the regular expression it replaces. It supports literal
+ * text, the "(.*)" captures, the ".*" skipped texts, their lazy forms "(.*?)" and ".*?", and "\\x" for
+ * a literal x such as "\\(". Any other regular expression syntax fails the build.
+ * The pattern matches the whole line, "^" and "$" being optional. The wildcards backtrack like a
+ * regular expression: the greedy ones try the last occurrence of the following text first, the lazy
+ * ones its first occurrence. Two wildcards cannot follow each other.
+ * match() does not allocate, the captures being views on the line.
+ * ex: LinePattern<"^Table: '(.*?)' (.*?)-max .* Seat #(.*) is the button$">::match(line)
+ */
+template<FixedString PATTERN>
+class [[nodiscard]] LinePattern final {
+private:
+  enum class /*[[nodiscard]]*/ PieceKind : short { literal, capture, skip };
+
+  struct [[nodiscard]] Piece final {
+    PieceKind kind { PieceKind::literal };
+    bool isLazy { false };
+    std::size_t textStart { 0 }; // for a literal, in Compiled::text
+    std::size_t textSize { 0 };
+    std::size_t captureIndex { 0 };
+  };
+
+  static constexpr std::size_t MAX_SIZE { PATTERN.view().size() + 1 };
+
+  struct [[nodiscard]] Compiled final {
+    std::array<Piece, MAX_SIZE> pieces {};
+    std::size_t nbPieces { 0 };
+    std::array<char, MAX_SIZE> text {}; // the unescaped literals
+    std::size_t nbCaptures { 0 };
+  };
+
+  [[nodiscard]] static consteval Compiled compile() {
+    constexpr std::array<std::pair<std::string_view, std::pair<PieceKind, bool>>, 4> WILDCARDS { {
+        { "(.*?)", { PieceKind::capture, true } }, { "(.*)", { PieceKind::capture, false } },
+        { ".*?", { PieceKind::skip, true } }, { ".*", { PieceKind::skip, false } }
+      }
+    };
+    auto pattern { PATTERN.view() };
+
+    if (pattern.starts_with('^')) { pattern.remove_prefix(1); }
+
+    if (pattern.ends_with('$') and !pattern.ends_with("\\$")) { pattern.remove_suffix(1); }
+
+    Compiled ret;
+    std::size_t textSize { 0 };
+
+    for (std::size_t pos { 0 }; pos < pattern.size();) {
+      const auto wildcard { std::ranges::find_if(WILDCARDS, [&](const auto & entry) {
+        return pattern.substr(pos).starts_with(entry.first);
+      }) };
+
+      if (WILDCARDS.end() != wildcard) {
+        if (0 < ret.nbPieces and PieceKind::literal != ret.pieces[ret.nbPieces - 1].kind) {
+          throw std::invalid_argument("Two wildcards follow each other in LinePattern");
+        }
+
+        const auto [kind, isLazy] { wildcard->second };
+        ret.pieces[ret.nbPieces++] = { .kind = kind, .isLazy = isLazy, .captureIndex = ret.nbCaptures };
+        ret.nbCaptures += PieceKind::capture == kind ? 1 : 0;
+        pos += wildcard->first.size();
+        continue;
+      }
+
+      auto c { pattern[pos++] };
+
+      if ('\\' == c) {
+        if (pos == pattern.size()) { throw std::invalid_argument("LinePattern ends with '\\'"); }
+
+        c = pattern[pos++];
+      } else if (std::string_view { "^$.*+?()[]{}|" }.contains(c)) {
+        throw std::invalid_argument("Unsupported regular expression syntax in LinePattern");
+      }
+
+      if (0 == ret.nbPieces or PieceKind::literal != ret.pieces[ret.nbPieces - 1].kind) {
+        ret.pieces[ret.nbPieces++] = { .kind = PieceKind::literal, .textStart = textSize };
+      }
+
+      ret.text[textSize++] = c;
+      ++ret.pieces[ret.nbPieces - 1].textSize;
+    }
 
-      case '4': [[fallthrough]];
+    return ret;
+  }
 
-      case '5': [[fallthrough]];
+  static constexpr Compiled COMPILED { compile() };
 
-      case '6': [[fallthrough]];
+public:
+  static constexpr std::size_t NB_CAPTURES { COMPILED.nbCaptures };
+  using Captures = std::array<std::string_view, NB_CAPTURES>;
 
-      case '7': [[fallthrough]];
+  /**
+   * @returns the captures of the line, or std::nullopt if the line does not match the pattern.
+   */
+  [[nodiscard]] static constexpr std::optional<Captures> match(std::string_view line) noexcept {
+    Captures ret {};
 
-      case '8': [[fallthrough]];
+    if (matchFrom<0>(line, 0, ret)) { return ret; }
 
-      case '9': { token.push_back(c); } break;
+    return {};
+  }
 
-      case '+': { ret += toDouble(token); token.clear(); } break;
+private:
+  [[nodiscard]] static constexpr std::string_view getText(const Piece& piece) noexcept {
+    return { COMPILED.text.data() + piece.textStart, piece.textSize };
+  }
 
-      default: break;
+  // the piece index being a template argument, each pattern is compiled into its own matcher
+  template<std::size_t PIECE_INDEX>
+  [[nodiscard]] static constexpr bool matchFrom(std::string_view line, std::size_t pos, Captures& captures) noexcept {
+    if constexpr (COMPILED.nbPieces == PIECE_INDEX) { return line.size() == pos; }
+    else {
+      constexpr auto PIECE { COMPILED.pieces[PIECE_INDEX] };
+
+      if constexpr (PieceKind::literal == PIECE.kind) {
+        constexpr auto TEXT { getText(PIECE) };
+        return line.substr(pos).starts_with(TEXT) and matchFrom<PIECE_INDEX + 1>(line, pos + TEXT.size(), captures);
+      } else {
+        // a wildcard, ending at the line end or at one of the occurrences of the following literal
+        const auto wildcardMatches { [&](std::size_t end) {
+          if constexpr (PieceKind::capture == PIECE.kind) { captures[PIECE.captureIndex] = line.substr(pos, end - pos); }
+
+          return true;
+        } };
+
+        if constexpr (COMPILED.nbPieces == PIECE_INDEX + 1) { return wildcardMatches(line.size()); }
+        else {
+          constexpr auto NEXT { getText(COMPILED.pieces[PIECE_INDEX + 1]) };
+
+          if (line.size() < pos + NEXT.size()) { return false; }
+
+          if constexpr (COMPILED.nbPieces == PIECE_INDEX + 2) {
+            // the following literal ends the line
+            return line.ends_with(NEXT) and wildcardMatches(line.size() - NEXT.size());
+          } else if constexpr (PIECE.isLazy) {
+            for (auto end { line.find(NEXT, pos) }; std::string_view::npos != end; end = line.find(NEXT, end + 1)) {
+              if (matchFrom<PIECE_INDEX + 2>(line, end + NEXT.size(), captures)) { return wildcardMatches(end); }
+            }
+
+            return false;
+          } else {
+            // rfind(NEXT) compares NEXT at each position, looking for its first char is faster
+            for (auto end { line.rfind(NEXT.front(), line.size() - NEXT.size()) }; std::string_view::npos != end and pos <= end;
+                 end = 0 == end ? std::string_view::npos : line.rfind(NEXT.front(), end - 1)) {
+              if (line.substr(end).starts_with(NEXT) and matchFrom<PIECE_INDEX + 2>(line, end + NEXT.size(), captures)) {
+                return wildcardMatches(end);
+              }
+            }
+
+            return false;
+          }
+        }
+      }
     }
-  });
+  }
+}; // class LinePattern
+} // namespace language::strings
 
-  if (!token.empty()) { ret += toDouble(token); }
+module : private;
 
-  return ret;
+[[nodiscard]]  std::string_view language::strings::myTrim(std::string_view s) {
+  s.remove_prefix(gsl::narrow_cast<std::string_view::size_type>(std::distance(s.cbegin(),
+                  std::find_if_not(s.cbegin(), s.cend(), isSpace))));
+  s.remove_suffix(gsl::narrow_cast<std::string_view::size_type>(std::distance(s.crbegin(),
+                  std::find_if_not(s.crbegin(), s.crend(), isSpace))));
+  return s;
 }
 
-[[nodiscard]] double language::strings::toAmount(std::string_view amount) {
-  // because of default US locale, the decimal separator must be '.'
-  std::string ret { amount };
-  std::ranges::replace(ret, ',', '.');
-  return toDouble(ret);
+[[nodiscard]] std::string language::strings::sanitize(std::string_view toBeSanitized) {
+  std::string ret { myTrim(toBeSanitized) };
+  std::ranges::replace(ret, '\'', '-');
+  return ret;
 }
 
 template<typename TYPE>
 static inline TYPE toType(std::string_view s) {
   const auto str { language::strings::myTrim(s) };
   TYPE ret { 0 };
-  const auto [ptr, errorCode] { std::from_chars(str.data(), str.data() + s.size(), ret) };
+  const auto [ptr, errorCode] { std::from_chars(str.data(), str.data() + str.size(), ret) };
 
   if (std::errc() == errorCode) {
     return ret;
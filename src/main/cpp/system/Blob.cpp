@@ -0,0 +1,80 @@
+module;
+
+export module system.Blob;
+
+#pragma warning( push )
+#pragma warning( disable : 4686)
+import std;
+#pragma warning( pop )
+
+/**
+ * Values that can be copied byte by byte into a blob.
+ */
+export template<typename T>
+concept BlobValue = std::is_trivially_copyable_v<T> and !std::is_pointer_v<T>;
+
+/**
+ * Builds a binary blob. Values are written in the native byte order: a blob is meant to be read
+ * back on the machine that wrote it.
+ */
+export class [[nodiscard]] BlobWriter final {
+private:
+  std::string m_bytes {};
+
+public:
+  template<BlobValue T>
+  void write(const T& value) {
+    const auto offset { m_bytes.size() };
+    m_bytes.resize(offset + sizeof(T));
+    std::memcpy(m_bytes.data() + offset, &value, sizeof(T));
+  }
+
+  /**
+   * Writes the string size followed by its characters.
+   */
+  void writeString(std::string_view s) {
+    write(static_cast<std::uint32_t>(s.size()));
+    m_bytes.append(s);
+  }
+
+  [[nodiscard]] std::string_view getBytes() const noexcept { return m_bytes; }
+}; // class BlobWriter
+
+/**
+ * Reads a binary blob written by a BlobWriter.
+ * Reading past the end of the blob throws an std::out_of_range.
+ */
+export class [[nodiscard]] BlobReader final {
+private:
+  std::string_view m_bytes;
+  std::size_t m_position { 0 };
+
+  void checkAvailable(std::size_t nbBytes) const {
+    if (m_bytes.size() - m_position < nbBytes) { throw std::out_of_range("truncated blob"); }
+  }
+
+public:
+  explicit BlobReader(std::string_view bytes) noexcept : m_bytes { bytes } {}
+
+  template<BlobValue T>
+  [[nodiscard]] T read() {
+    checkAvailable(sizeof(T));
+    T ret;
+    std::memcpy(&ret, m_bytes.data() + m_position, sizeof(T));
+    m_position += sizeof(T);
+    return ret;
+  }
+
+  /**
+   * @returns a view on the string, valid as long as the blob bytes are.
+   */
+  [[nodiscard]] std::string_view readString() {
+    const auto size { read<std::uint32_t>() };
+    checkAvailable(size);
+    const auto ret { m_bytes.substr(m_position, size) };
+    m_position += size;
+    return ret;
+  }
+
+  [[nodiscard]] bool isAtEnd() const noexcept { return m_bytes.size() == m_position; }
+}; // class BlobReader
@@ -0,0 +1,63 @@
+module;
+
+export module system.ConcurrentMap;
+
+#pragma warning( push )
+#pragma warning( disable : 4686)
+import std;
+#pragma warning( pop )
+
+/**
+ * A map that several threads can fill concurrently. The entries are spread over shards by the hash
+ * of their key, each shard having its own mutex, so that threads using different keys seldom wait
+ * for each other.
+ */
+export template<typename K, typename V, typename HASH = std::hash<K>>
+class [[nodiscard]] ConcurrentMap final {
+private:
+  static constexpr std::size_t NB_SHARDS { 16 }; // a power of 2
+
+  struct [[nodiscard]] Shard final {
+    std::mutex m_mutex {};
+    std::unordered_map<K, V, HASH> m_values {};
+  };
+
+  std::array<Shard, NB_SHARDS> m_shards {};
+
+  [[nodiscard]] Shard& getShard(const K& key) noexcept {
+    // the high bits, as the map of the shard buckets its entries by their low bits
+    return m_shards[(HASH {}(key) >> (std::numeric_limits<std::size_t>::digits - std::countr_zero(NB_SHARDS)))];
+  }
+
+public:
+  ConcurrentMap() = default;
+  ConcurrentMap(const ConcurrentMap&) = delete;
+  ConcurrentMap(ConcurrentMap&&) = delete;
+  ConcurrentMap& operator=(const ConcurrentMap&) = delete;
+  ConcurrentMap& operator=(ConcurrentMap&&) = delete;
+  ~ConcurrentMap() = default;
+
+  /**
+   * Maps key to value if key is missing, else to combine(the current value, value). With an
+   * associative and commutative combine, such as std::ranges::min, the final value does not
+   * depend on the order the threads call this method in.
+   */
+  template<typename COMBINE>
+  void insertOrCombine(const K& key, const V& value, COMBINE combine) {
+    auto& shard { getShard(key) };
+    const std::lock_guard lock { shard.m_mutex };
+
+    if (auto [it, isNew] { shard.m_values.try_emplace(key, value) }; !isNew) {
+      it->second = combine(it->second, value);
+    }
+  }
+
+  [[nodiscard]] std::optional<V> find(const K& key) {
+    auto& shard { getShard(key) };
+    const std::lock_guard lock { shard.m_mutex };
+
+    if (const auto it { shard.m_values.find(key) }; shard.m_values.end() != it) { return it->second; }
+
+    return {};
+  }
+}; // class ConcurrentMap
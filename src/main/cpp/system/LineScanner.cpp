@@ -0,0 +1,189 @@
+module;
+
+#if defined(_M_X64) || defined(__x86_64__) || defined(_M_IX86) || defined(__i386__)
+#  define PRM_X86
+#  include <immintrin.h> // _mm_*, _mm256_*
+#  if defined(_MSC_VER)
+#    include <intrin.h> // __cpuid, __cpuidex, _xgetbv
+#  endif
+#endif
+
+// gcc and clang need to be told that a function uses AVX2 instructions, msvc does not
+#if defined(PRM_X86) && (defined(__GNUC__) || defined(__clang__))
+#  define PRM_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#  define PRM_TARGET_AVX2
+#endif
+
+export module system.LineScanner;
+
+#pragma warning( push )
+#pragma warning( disable : 4686)
+import std;
+#pragma warning( pop )
+
+/**
+ * The instruction set used to look for end of lines.
+ */
+export enum class /*[[nodiscard]]*/ LineScanner : short { scalar, sse2, avx2 };
+
+export namespace lineScanner {
+/**
+ * @returns the fastest scanner the current CPU supports for history files. Detected once.
+ * History lines are about 30 bytes long, so SSE2 is preferred to AVX2: a 32 bytes wide search
+ * rarely pays for itself on such lines (see the line scanner benchmark).
+ */
+[[nodiscard]] LineScanner best() noexcept;
+
+/**
+ * @returns true if the current CPU can run the given scanner.
+ */
+[[nodiscard]] bool isSupported(LineScanner scanner) noexcept;
+
+/**
+ * @returns the position of the first '\n' in text, starting at position from, or
+ * std::string_view::npos. A "\r\n" end of line is found by its '\n', the caller removes the '\r'.
+ */
+[[nodiscard]] std::size_t findNewline(LineScanner scanner, std::string_view text,
+                                      std::size_t from) noexcept;
+
+/**
+ * Same as findNewline(best(), text, from).
+ */
+[[nodiscard]] std::size_t findNewline(std::string_view text, std::size_t from) noexcept;
+
+[[nodiscard]] std::string_view toString(LineScanner scanner) noexcept;
+} // namespace lineScanner
+
+module : private;
+
+using NewlineFinder = const char* (*)(const char*, const char*) noexcept;
+
+[[nodiscard]] static const char* findNewlineScalar(const char* first, const char* last) noexcept {
+  return std::find(first, last, '\n');
+}
+
+#if defined(PRM_X86)
+
+[[nodiscard]] static const char* findNewlineSse2(const char* first, const char* last) noexcept {
+  const auto newlines { _mm_set1_epi8('\n') };
+
+  for (; 16 <= last - first; first += 16) {
+    const auto chunk { _mm_loadu_si128(reinterpret_cast<const __m128i*>(first)) };
+
+    if (const auto mask { static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, newlines))) };
+        0 != mask) {
+      return first + std::countr_zero(mask);
+    }
+  }
+
+  return findNewlineScalar(first, last);
+}
+
+PRM_TARGET_AVX2
+[[nodiscard]] static const char* findNewlineAvx2(const char* first, const char* last) noexcept {
+  const auto newlines { _mm256_set1_epi8('\n') };
+
+  for (; 32 <= last - first; first += 32) {
+    const auto chunk { _mm256_loadu_si256(reinterpret_cast<const __m256i*>(first)) };
+
+    if (const auto mask { static_cast<unsigned>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(chunk, newlines))) };
+        0 != mask) {
+      return first + std::countr_zero(mask);
+    }
+  }
+
+  return findNewlineSse2(first, last);
+}
+
+#  if defined(_MSC_VER)
+[[nodiscard]] static bool cpuHasAvx2() noexcept {
+  std::array<int, 4> info {};
+  __cpuid(info.data(), 0);
+
+  if (7 > info[0]) { return false; }
+
+  __cpuid(info.data(), 1);
+  const auto osSavesYmmRegisters { (0 != (info[2] & (1 << 27))) and (6 == (_xgetbv(0) & 6)) };
+  __cpuidex(info.data(), 7, 0);
+  return osSavesYmmRegisters and (0 != (info[1] & (1 << 5)));
+}
+
+[[nodiscard]] static bool cpuHasSse2() noexcept {
+  std::array<int, 4> info {};
+  __cpuid(info.data(), 1);
+  return 0 != (info[3] & (1 << 26));
+}
+#  else
+[[nodiscard]] static bool cpuHasAvx2() noexcept { return 0 != __builtin_cpu_supports("avx2"); }
+[[nodiscard]] static bool cpuHasSse2() noexcept { return 0 != __builtin_cpu_supports("sse2"); }
+#  endif // _MSC_VER
+
+#endif // PRM_X86
+
+bool lineScanner::isSupported(LineScanner scanner) noexcept {
+  switch (scanner) {
+    case LineScanner::scalar: return true;
+#if defined(PRM_X86)
+
+    case LineScanner::sse2: return cpuHasSse2();
+
+    case LineScanner::avx2: return cpuHasAvx2();
+#else
+
+    case LineScanner::sse2: [[fallthrough]];
+
+    case LineScanner::avx2: return false;
+#endif // PRM_X86
+  }
+
+  return false;
+}
+
+LineScanner lineScanner::best() noexcept {
+  static const auto ret { isSupported(LineScanner::sse2) ? LineScanner::sse2 : LineScanner::scalar };
+  return ret;
+}
+
+[[nodiscard]] static NewlineFinder toNewlineFinder(LineScanner scanner) noexcept {
+#if defined(PRM_X86)
+
+  if (LineScanner::avx2 == scanner and lineScanner::isSupported(scanner)) { return findNewlineAvx2; }
+
+  if (LineScanner::sse2 == scanner and lineScanner::isSupported(scanner)) { return findNewlineSse2; }
+
+#endif // PRM_X86
+  std::ignore = scanner;
+  return findNewlineScalar;
+}
+
+[[nodiscard]] static std::size_t findNewlineWith(NewlineFinder finder, std::string_view text,
+    std::size_t from) noexcept {
+  if (text.size() <= from) { return std::string_view::npos; }
+
+  const auto last { text.data() + text.size() };
+  const auto found { finder(text.data() + from, last) };
+  return last == found ? std::string_view::npos : static_cast<std::size_t>(found - text.data());
+}
+
+std::size_t lineScanner::findNewline(LineScanner scanner, std::string_view text,
+                                     std::size_t from) noexcept {
+  return findNewlineWith(toNewlineFinder(scanner), text, from);
+}
+
+std::size_t lineScanner::findNewline(std::string_view text, std::size_t from) noexcept {
+  static const auto bestFinder { toNewlineFinder(best()) };
+  return findNewlineWith(bestFinder, text, from);
+}
+
+std::string_view lineScanner::toString(LineScanner scanner) noexcept {
+  switch (scanner) {
+    case LineScanner::scalar: return "scalar";
+
+    case LineScanner::sse2: return "sse2";
+
+    case LineScanner::avx2: return "avx2";
+  }
+
+  return "unknown";
+}
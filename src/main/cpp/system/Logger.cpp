@@ -0,0 +1,302 @@
+module;
+
+// the lowest log level compiled in: 0 trace, 1 debug, 2 info, 3 warning, 4 error, 5 none
+#if !defined(PRM_LOG_LEVEL)
+#  if defined(NDEBUG)
+#    define PRM_LOG_LEVEL 2
+#  else
+#    define PRM_LOG_LEVEL 1
+#  endif
+#endif
+
+export module system.Logger;
+
+#pragma warning( push )
+#pragma warning( disable : 4686)
+import std;
+#pragma warning( pop )
+
+export enum class /*[[nodiscard]]*/ LogLevel : short { trace, debug, info, warning, error, none };
+
+export enum class /*[[nodiscard]]*/ LogCategory : short { parser, import, file };
+
+/**
+ * Leveled logging.
+ * A message is formatted by the thread logging it, into a ring buffer owned by that thread. A
+ * background thread writes the buffers content on the standard output, or on the error output for
+ * warnings and errors. Logging never waits: when a ring buffer is full, the message is dropped and
+ * counted.
+ * The levels below PRM_LOG_LEVEL are removed at compile time. The arguments are still evaluated by
+ * the caller, so pass cheap ones (numbers, views) to messages logged once per hand or per line.
+ */
+export namespace logger {
+inline constexpr LogLevel COMPILED_LEVEL { static_cast<LogLevel>(PRM_LOG_LEVEL) };
+inline constexpr std::size_t MAX_MESSAGE_SIZE { 240 }; // longer messages are truncated
+
+/**
+ * Sets the lowest level logged, among the ones compiled in.
+ */
+void setLevel(LogLevel level) noexcept;
+void setCategoryEnabled(LogCategory category, bool isEnabled) noexcept;
+[[nodiscard]] bool isEnabled(LogLevel level, LogCategory category) noexcept;
+
+/**
+ * Queues an already formatted message.
+ */
+void write(LogLevel level, LogCategory category, std::string_view message) noexcept;
+
+/**
+ * Writes the queued messages now.
+ */
+void flush();
+
+template<LogLevel LEVEL, typename... ARGS>
+void log(LogCategory category, std::format_string<ARGS...> format, ARGS&&... args) {
+  if constexpr (COMPILED_LEVEL <= LEVEL and LogLevel::none != LEVEL) {
+    if (isEnabled(LEVEL, category)) {
+      std::array<char, MAX_MESSAGE_SIZE> message;
+      const auto result { std::format_to_n(message.data(), message.size(), format, std::forward<ARGS>(args)...) };
+      write(LEVEL, category, { message.data(), std::min(message.size(), static_cast<std::size_t>(result.size)) });
+    }
+  }
+}
+
+template<typename... ARGS>
+void trace(LogCategory category, std::format_string<ARGS...> format, ARGS&&... args) {
+  log<LogLevel::trace>(category, format, std::forward<ARGS>(args)...);
+}
+
+template<typename... ARGS>
+void debug(LogCategory category, std::format_string<ARGS...> format, ARGS&&... args) {
+  log<LogLevel::debug>(category, format, std::forward<ARGS>(args)...);
+}
+
+template<typename... ARGS>
+void info(LogCategory category, std::format_string<ARGS...> format, ARGS&&... args) {
+  log<LogLevel::info>(category, format, std::forward<ARGS>(args)...);
+}
+
+template<typename... ARGS>
+void warning(LogCategory category, std::format_string<ARGS...> format, ARGS&&... args) {
+  log<LogLevel::warning>(category, format, std::forward<ARGS>(args)...);
+}
+
+template<typename... ARGS>
+void error(LogCategory category, std::format_string<ARGS...> format, ARGS&&... args) {
+  log<LogLevel::error>(category, format, std::forward<ARGS>(args)...);
+}
+} // namespace logger
+
+module : private;
+
+// messages per thread, about 16 KB, the flusher being woken once half of them are used
+static constexpr std::size_t RING_CAPACITY { 64 };
+// how long the flusher waits for more messages once one is queued, to write them together
+static constexpr auto FLUSH_PERIOD { std::chrono::milliseconds(20) };
+
+[[nodiscard]] static constexpr std::string_view toString(LogLevel level) noexcept {
+  constexpr std::array<std::string_view, 6> LEVEL_NAMES { "trace", "debug", "info", "warning", "error", "none" };
+  return LEVEL_NAMES.at(static_cast<std::size_t>(level));
+}
+
+[[nodiscard]] static constexpr std::string_view toString(LogCategory category) noexcept {
+  constexpr std::array<std::string_view, 3> CATEGORY_NAMES { "parser", "import", "file" };
+  return CATEGORY_NAMES.at(static_cast<std::size_t>(category));
+}
+
+struct [[nodiscard]] LogRecord final {
+  LogLevel level { LogLevel::none };
+  LogCategory category { LogCategory::parser };
+  std::uint8_t size { 0 };
+  std::array<char, logger::MAX_MESSAGE_SIZE> text {};
+};
+
+static_assert(std::numeric_limits<std::uint8_t>::max() >= logger::MAX_MESSAGE_SIZE and "LogRecord::size too small");
+
+// a lock free ring buffer with a single producer, the thread owning it, and a single consumer
+class [[nodiscard]] RingBuffer final {
+private:
+  std::array<LogRecord, RING_CAPACITY> m_records {};
+  alignas(64) std::atomic_size_t m_head { 0 }; // the next record written by the producer
+  alignas(64) std::atomic_size_t m_tail { 0 }; // the next record read by the consumer
+  std::atomic_size_t m_nbDropped { 0 };
+  std::atomic_bool m_isOrphan { false }; // the producer thread is gone
+
+public:
+  // @returns true if the buffer is half full, so that it should be drained without waiting
+  [[nodiscard]] bool push(LogLevel level, LogCategory category, std::string_view message) noexcept {
+    const auto head { m_head.load(std::memory_order_relaxed) };
+    const auto nbUsed { head - m_tail.load(std::memory_order_acquire) };
+
+    if (RING_CAPACITY == nbUsed) {
+      m_nbDropped.fetch_add(1, std::memory_order_relaxed);
+      return true;
+    }
+
+    auto& record { m_records[head % RING_CAPACITY] };
+    record.level = level;
+    record.category = category;
+    record.size = static_cast<std::uint8_t>(std::min(message.size(), record.text.size()));
+    std::copy_n(message.data(), record.size, record.text.data());
+    m_head.store(head + 1, std::memory_order_release);
+    return RING_CAPACITY / 2 <= nbUsed + 1;
+  }
+
+  // calls sink(const LogRecord&) for each record, then frees them
+  void drain(const auto& sink) {
+    const auto tail { m_tail.load(std::memory_order_relaxed) };
+    const auto head { m_head.load(std::memory_order_acquire) };
+
+    for (auto i { tail }; i < head; ++i) { sink(m_records[i % RING_CAPACITY]); }
+
+    m_tail.store(head, std::memory_order_release);
+  }
+
+  [[nodiscard]] std::size_t takeNbDropped() noexcept { return m_nbDropped.exchange(0, std::memory_order_relaxed); }
+  void setOrphan() noexcept { m_isOrphan.store(true, std::memory_order_release); }
+
+  [[nodiscard]] bool isOrphanAndEmpty() const noexcept {
+    return m_isOrphan.load(std::memory_order_acquire)
+           and m_head.load(std::memory_order_acquire) == m_tail.load(std::memory_order_relaxed);
+  }
+}; // class RingBuffer
+
+// owns the ring buffers of all the threads and writes their content
+class [[nodiscard]] LogFlusher final {
+private:
+  std::mutex m_buffersMutex {};
+  std::vector<std::shared_ptr<RingBuffer>> m_buffers {};
+  std::mutex m_drainMutex {}; // a single thread drains the buffers at a time
+  std::mutex m_wakeMutex {};
+  std::condition_variable_any m_wake {};
+  std::atomic_bool m_hasMessages { false }; // set by the first message queued since the last drain
+  std::atomic_bool m_isUrgent { false }; // set by the messages that should not wait for the period
+  std::jthread m_thread; // last member, so that it stops before the other members are destroyed
+
+  // sleeps until a message is queued, then gives the period to the other messages before writing
+  void run(std::stop_token stopToken) {
+    while (!stopToken.stop_requested()) {
+      {
+        std::unique_lock lock { m_wakeMutex };
+
+        if (!m_wake.wait(lock, stopToken, [this]() noexcept { return m_hasMessages.load(); })) { return; }
+
+        std::ignore = m_wake.wait_for(lock, stopToken, FLUSH_PERIOD, [this]() noexcept { return m_isUrgent.load(); });
+      }
+      // cleared before draining, so that the messages queued meanwhile wake the next iteration
+      m_hasMessages.store(false);
+      m_isUrgent.store(false);
+      drainAll();
+    }
+  }
+
+  void notify() {
+    // locked, so that the notification can't come between the check of the flags and the wait
+    { const std::lock_guard lock { m_wakeMutex }; }
+    m_wake.notify_one();
+  }
+
+public:
+  LogFlusher() : m_thread { [this](std::stop_token stopToken) { run(stopToken); } } {}
+  LogFlusher(const LogFlusher&) = delete;
+  LogFlusher(LogFlusher&&) = delete;
+  LogFlusher& operator=(const LogFlusher&) = delete;
+  LogFlusher& operator=(LogFlusher&&) = delete;
+
+  ~LogFlusher() {
+    m_thread.request_stop();
+    m_thread.join();
+    drainAll();
+  }
+
+  [[nodiscard]] std::shared_ptr<RingBuffer> addBuffer() {
+    auto ret { std::make_shared<RingBuffer>() };
+    const std::lock_guard lock { m_buffersMutex };
+    m_buffers.push_back(ret);
+    return ret;
+  }
+
+  // called after each message, notifying only the first one since the last drain and the urgent ones
+  void onMessage(bool isUrgent) {
+    if (isUrgent and !m_isUrgent.exchange(true)) {
+      m_hasMessages.store(true);
+      notify();
+    } else if (!m_hasMessages.load(std::memory_order_relaxed) and !m_hasMessages.exchange(true)) { notify(); }
+  }
+
+  void drainAll() {
+    const std::lock_guard drainLock { m_drainMutex };
+    std::vector<std::shared_ptr<RingBuffer>> buffers;
+    {
+      const std::lock_guard lock { m_buffersMutex };
+      // the buffers of the gone threads are removed once written
+      std::erase_if(m_buffers, [](const auto & pBuffer) { return pBuffer->isOrphanAndEmpty(); });
+      buffers = m_buffers;
+    }
+    std::string out;
+    std::string err;
+    std::ranges::for_each(buffers, [&out, &err](const auto & pBuffer) {
+      pBuffer->drain([&out, &err](const LogRecord & record) {
+        auto& text { LogLevel::warning <= record.level ? err : out };
+        std::format_to(std::back_inserter(text), "[{}][{}] {}\n", toString(record.level), toString(record.category),
+                       std::string_view(record.text.data(), record.size));
+      });
+
+      if (const auto nbDropped { pBuffer->takeNbDropped() }; 0 < nbDropped) {
+        std::format_to(std::back_inserter(err), "[warning][log] {} messages dropped\n", nbDropped);
+      }
+    });
+
+    if (!out.empty()) { std::cout << out << std::flush; }
+
+    if (!err.empty()) { std::cerr << err << std::flush; }
+  }
+}; // class LogFlusher
+
+[[nodiscard]] static LogFlusher& getFlusher() {
+  static LogFlusher flusher;
+  return flusher;
+}
+
+// the ring buffer of the current thread, kept by the flusher until written after the thread is gone
+struct [[nodiscard]] ThreadBuffer final {
+  std::shared_ptr<RingBuffer> m_pBuffer { getFlusher().addBuffer() };
+
+  ThreadBuffer() = default;
+  ThreadBuffer(const ThreadBuffer&) = delete;
+  ThreadBuffer(ThreadBuffer&&) = delete;
+  ThreadBuffer& operator=(const ThreadBuffer&) = delete;
+  ThreadBuffer& operator=(ThreadBuffer&&) = delete;
+  ~ThreadBuffer() { m_pBuffer->setOrphan(); }
+};
+
+static std::atomic<LogLevel> s_level { logger::COMPILED_LEVEL };
+static std::atomic_uint s_disabledCategories { 0 }; // a bit per category
+
+void logger::setLevel(LogLevel level) noexcept { s_level.store(std::max(level, COMPILED_LEVEL), std::memory_order_relaxed); }
+
+void logger::setCategoryEnabled(LogCategory category, bool isEnabled) noexcept {
+  const auto bit { 1U << static_cast<unsigned>(category) };
+
+  if (isEnabled) { s_disabledCategories.fetch_and(~bit, std::memory_order_relaxed); }
+  else { s_disabledCategories.fetch_or(bit, std::memory_order_relaxed); }
+}
+
+bool logger::isEnabled(LogLevel level, LogCategory category) noexcept {
+  return s_level.load(std::memory_order_relaxed) <= level
+         and 0 == (s_disabledCategories.load(std::memory_order_relaxed) & (1U << static_cast<unsigned>(category)));
+}
+
+void logger::write(LogLevel level, LogCategory category, std::string_view message) noexcept {
+  try {
+    // allocated by the first message of the thread, and by the first message at all for the flusher
+    thread_local ThreadBuffer buffer;
+    const auto isBufferHalfFull { buffer.m_pBuffer->push(level, category, message) };
+    // don't wait for the flush period to show problems, or to drop messages
+    getFlusher().onMessage(LogLevel::warning <= level or isBufferHalfFull);
+  } catch (const std::exception&) {
+    // out of memory or threads: the message is lost, the allocation being tried again by the next one
+  }
+}
+
+void logger::flush() { getFlusher().drainAll(); }
@@ -0,0 +1,111 @@
+module;
+
+#if defined(_WIN32)
+#  define WIN32_LEAN_AND_MEAN
+#  define NOMINMAX
+#  include <windows.h> // CreateFileW, CreateFileMappingW, MapViewOfFile
+#else
+#  include <fcntl.h> // open
+#  include <sys/mman.h> // mmap, munmap
+#  include <sys/stat.h> // fstat
+#  include <unistd.h> // close
+#endif
+
+export module system.MappedFile;
+
+#pragma warning( push )
+#pragma warning( disable : 4686)
+import std;
+#pragma warning( pop )
+
+/**
+ * A read-only memory mapping of a whole file.
+ * The mapped bytes stay valid as long as the MappedFile object lives.
+ */
+export class [[nodiscard]] MappedFile final {
+private:
+  const char* m_data { nullptr };
+  std::size_t m_size { 0 };
+
+public:
+  /**
+   * Maps the given file. If the mapping fails, isMapped() returns false.
+   */
+  explicit MappedFile(const std::filesystem::path& file) noexcept;
+  // use only std::filesystem::path
+  MappedFile(auto file) = delete;
+  // non copyable
+  MappedFile(const MappedFile&) = delete;
+  MappedFile(MappedFile&&) = delete;
+  MappedFile& operator=(const MappedFile&) = delete;
+  MappedFile& operator=(MappedFile&&) = delete;
+  ~MappedFile();
+
+  [[nodiscard]] bool isMapped() const noexcept { return nullptr != m_data; }
+  [[nodiscard]] std::size_t size() const noexcept { return m_size; }
+
+  /**
+   * @returns the mapped bytes, or an empty view if the file could not be mapped.
+   */
+  [[nodiscard]] std::string_view view() const noexcept { return { m_data, m_size }; }
+}; // class MappedFile
+
+module : private;
+
+#if defined(_WIN32)
+
+MappedFile::MappedFile(const std::filesystem::path& file) noexcept {
+  const auto hFile { ::CreateFileW(file.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr,
+                                   OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr) };
+
+  if (INVALID_HANDLE_VALUE == hFile) { return; }
+
+  LARGE_INTEGER fileSize {};
+
+  // an empty file can't be mapped
+  if (0 != ::GetFileSizeEx(hFile, &fileSize) and 0 < fileSize.QuadPart) {
+    if (const auto hMapping { ::CreateFileMappingW(hFile, nullptr, PAGE_READONLY, 0, 0, nullptr) };
+        nullptr != hMapping) {
+      m_data = static_cast<const char*>(::MapViewOfFile(hMapping, FILE_MAP_READ, 0, 0, 0));
+      m_size = nullptr == m_data ? 0 : static_cast<std::size_t>(fileSize.QuadPart);
+      // the view keeps a reference on the mapping object
+      ::CloseHandle(hMapping);
+    }
+  }
+
+  ::CloseHandle(hFile);
+}
+
+MappedFile::~MappedFile() {
+  if (nullptr != m_data) { ::UnmapViewOfFile(m_data); }
+}
+
+#else
+
+MappedFile::MappedFile(const std::filesystem::path& file) noexcept {
+  const auto fd { ::open(file.c_str(), O_RDONLY) };
+
+  if (-1 == fd) { return; }
+
+  struct stat fileStatus {};
+
+  // an empty file can't be mapped
+  if (0 == ::fstat(fd, &fileStatus) and 0 < fileStatus.st_size) {
+    const auto size { static_cast<std::size_t>(fileStatus.st_size) };
+
+    if (auto pData { ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0) }; MAP_FAILED != pData) {
+      ::madvise(pData, size, MADV_SEQUENTIAL);
+      m_data = static_cast<const char*>(pData);
+      m_size = size;
+    }
+  }
+
+  // the mapping keeps a reference on the file
+  ::close(fd);
+}
+
+MappedFile::~MappedFile() {
+  if (nullptr != m_data) { ::munmap(const_cast<char*>(m_data), m_size); }
+}
+
+#endif // _WIN32
@@ -0,0 +1,54 @@
+module;
+
+export module system.MemoryArena;
+
+#pragma warning( push )
+#pragma warning( disable : 4686)
+import std;
+#pragma warning( pop )
+
+/**
+ * Destroys an object created in a MemoryArena, its memory being released with the arena.
+ */
+export template<typename T>
+struct [[nodiscard]] ArenaDeleter final {
+  void operator()(T* p) const noexcept { std::destroy_at(p); }
+};
+
+/**
+ * An object owned by a MemoryArena. It must be destroyed before its arena.
+ */
+export template<typename T>
+using ArenaPtr = std::unique_ptr<T, ArenaDeleter<T>>;
+
+/**
+ * The memory of objects sharing the same lifetime, such as the hands of a history file.
+ * The memory is taken from the heap by growing blocks and is given back all at once when the arena
+ * is destroyed, so creating an object is usually a pointer increment.
+ * An arena is not thread safe: each parsing thread fills its own.
+ */
+export class [[nodiscard]] MemoryArena final {
+private:
+  std::pmr::monotonic_buffer_resource m_resource;
+
+public:
+  static constexpr std::size_t INITIAL_SIZE { 64 * 1024 };
+
+  explicit MemoryArena(std::size_t initialSize = INITIAL_SIZE) : m_resource { initialSize } {}
+  MemoryArena(const MemoryArena&) = delete;
+  MemoryArena(MemoryArena&&) = delete;
+  MemoryArena& operator=(const MemoryArena&) = delete;
+  MemoryArena& operator=(MemoryArena&&) = delete;
+  ~MemoryArena() = default;
+
+  [[nodiscard]] std::pmr::polymorphic_allocator<> getAllocator() noexcept { return &m_resource; }
+
+  /**
+   * Creates an object in the arena. If T has an allocator_type, the arena allocator is given to its
+   * constructor as last argument, so that T can put its own data in the arena.
+   */
+  template<typename T, typename... ARGS>
+  [[nodiscard]] ArenaPtr<T> make(ARGS&&... args) {
+    return ArenaPtr<T> { getAllocator().new_object<T>(std::forward<ARGS>(args)...) };
+  }
+}; // class MemoryArena
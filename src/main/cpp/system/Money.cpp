@@ -0,0 +1,88 @@
+module;
+
+export module system.Money;
+
+#pragma warning( push )
+#pragma warning( disable : 4686)
+import std;
+#pragma warning( pop )
+
+/**
+ * An amount of money, or of tournament chips, as an exact number of cents.
+ */
+export class [[nodiscard]] Money final {
+private:
+  std::int64_t m_cents { 0 };
+
+  explicit constexpr Money(std::int64_t cents) noexcept : m_cents { cents } {}
+
+public:
+  constexpr Money() noexcept = default;
+  [[nodiscard]] static constexpr Money fromCents(std::int64_t cents) noexcept { return Money { cents }; }
+  [[nodiscard]] constexpr std::int64_t toCents() const noexcept { return m_cents; }
+  [[nodiscard]] constexpr double toDouble() const noexcept { return static_cast<double>(m_cents) / 100.0; }
+  [[nodiscard]] constexpr auto operator<=>(const Money&) const noexcept = default;
+  constexpr Money& operator+=(Money other) noexcept { m_cents += other.m_cents; return *this; }
+  constexpr Money& operator-=(Money other) noexcept { m_cents -= other.m_cents; return *this; }
+  [[nodiscard]] friend constexpr Money operator+(Money a, Money b) noexcept { return a += b; }
+  [[nodiscard]] friend constexpr Money operator-(Money a, Money b) noexcept { return a -= b; }
+}; // class Money
+
+export namespace money {
+/**
+ * Parses an amount such as "1,28€", "0.02€" or "1500", in a single pass and without allocating.
+ * Leading spaces are skipped, ',' and '.' are both decimal separators, the decimals after the
+ * cents are ignored and the parsing stops at the first character that is not part of the amount.
+ * @returns zero if the text does not start with an amount.
+ */
+[[nodiscard]] constexpr Money parse(std::string_view amount) noexcept {
+  const auto isDigit { [](char c) noexcept { return '0' <= c and c <= '9'; } };
+  std::size_t i { 0 };
+
+  while (i < amount.size() and ' ' == amount[i]) { ++i; }
+
+  std::int64_t cents { 0 };
+
+  for (; i < amount.size() and isDigit(amount[i]); ++i) { cents = cents * 10 + (amount[i] - '0'); }
+
+  cents *= 100;
+
+  if (i < amount.size() and (',' == amount[i] or '.' == amount[i])) {
+    ++i;
+
+    for (std::int64_t unit { 10 }; 0 < unit and i < amount.size() and isDigit(amount[i]); unit /= 10, ++i) {
+      cents += (amount[i] - '0') * unit;
+    }
+  }
+
+  return Money::fromCents(cents);
+}
+
+/**
+ * Parses a buy-in such as "0.45€ + 0.05€", without allocating.
+ * @returns the sum of its amounts, zero if it has none such as "Free".
+ */
+[[nodiscard]] constexpr Money parseBuyIn(std::string_view buyIn) noexcept {
+  constexpr std::string_view DIGITS { "0123456789" };
+  Money ret;
+
+  for (auto pos { buyIn.find_first_of(DIGITS) }; std::string_view::npos != pos;) {
+    ret += parse(buyIn.substr(pos));
+    const auto plusPos { buyIn.find('+', pos) };
+    pos = std::string_view::npos == plusPos ? plusPos : buyIn.find_first_of(DIGITS, plusPos);
+  }
+
+  return ret;
+}
+} // namespace money
+
+module : private;
+
+static_assert(money::parse("1,28€") == Money::fromCents(128));
+static_assert(money::parse(" 0.02€") == Money::fromCents(2));
+static_assert(money::parse("0.5") == Money::fromCents(50));
+static_assert(money::parse("1500") == Money::fromCents(150000));
+static_assert(money::parse("2.999") == Money::fromCents(299));
+static_assert(money::parse("Free") == Money {});
+static_assert(money::parseBuyIn("0.45€ + 0.05€") == Money::fromCents(50));
+static_assert(money::parseBuyIn("Free") == Money {});
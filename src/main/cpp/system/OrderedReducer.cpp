@@ -0,0 +1,173 @@
+module;
+
+#include <cassert> // assert
+
+export module system.OrderedReducer;
+
+#pragma warning( push )
+#pragma warning( disable : 4686)
+import std;
+#pragma warning( pop )
+
+/**
+ * Merges values given by index, in any order and from any thread, into the value that merging
+ * them from the first index to the last one gives.
+ * A value is merged with the values of the neighbouring indexes as soon as they are given, so that
+ * most of the merging is done while the other values are being computed. Only the neighbouring
+ * values are merged, a value being always merged into the one at its left, so the result does not
+ * depend on the order the values are given in as long as the merge is associative.
+ * The threads computing the values can take their indexes from claim(), which bounds the number of
+ * values computed or waiting to be merged.
+ * @param MERGE a function object called as merge(T& left, T&& right), merging right into left.
+ * It is called without any lock held.
+ */
+export template<typename T, typename MERGE>
+class [[nodiscard]] OrderedReducer final {
+private:
+  // the merged values of the consecutive indexes [start, end)
+  struct [[nodiscard]] Run final {
+    std::size_t end;
+    T value;
+  };
+
+  std::mutex m_mutex {};
+  std::condition_variable m_mergedEndChanged {};
+  std::map<std::size_t, Run> m_runs {}; // the runs waiting for a neighbour, by start index
+  std::size_t m_nbValues;
+  MERGE m_merge;
+  std::size_t m_maxNbPending;
+  std::vector<std::size_t> m_claimRanks; // indexed as the values, the lowest rank being claimed first
+  std::vector<bool> m_isClaimed;
+  std::size_t m_nbClaimed { 0 };
+  std::size_t m_mergedEnd { 0 }; // the values before this index are merged into the one of index 0
+
+  [[nodiscard]] static std::vector<std::size_t> toRanks(std::span<const std::size_t> claimOrder) {
+    std::vector<std::size_t> ret(claimOrder.size());
+
+    for (std::size_t rank { 0 }; rank < claimOrder.size(); ++rank) { ret[claimOrder[rank]] = rank; }
+
+    return ret;
+  }
+
+public:
+  /**
+   * Without any bound, claim() giving the indexes in increasing order.
+   */
+  OrderedReducer(std::size_t nbValues, MERGE merge)
+    : m_nbValues { nbValues }, m_merge { std::move(merge) }, m_maxNbPending { nbValues }, m_claimRanks(nbValues),
+      m_isClaimed(nbValues) {
+    std::iota(m_claimRanks.begin(), m_claimRanks.end(), std::size_t { 0 });
+  }
+
+  /**
+   * @param claimOrder the indexes of the values, in the order claim() should give them in
+   * @param maxNbPending the maximum number of claimed values not yet merged into the value of
+   * index 0, at least 1
+   */
+  OrderedReducer(std::span<const std::size_t> claimOrder, MERGE merge, std::size_t maxNbPending)
+    : m_nbValues { claimOrder.size() }, m_merge { std::move(merge) }, m_maxNbPending { maxNbPending },
+      m_claimRanks { toRanks(claimOrder) }, m_isClaimed(claimOrder.size()) {
+    assert(0 < maxNbPending and "nothing could be claimed");
+  }
+
+  OrderedReducer(const OrderedReducer&) = delete;
+  OrderedReducer(OrderedReducer&&) = delete;
+  OrderedReducer& operator=(const OrderedReducer&) = delete;
+  OrderedReducer& operator=(OrderedReducer&&) = delete;
+  ~OrderedReducer() = default;
+
+  /**
+   * @returns the index of a value to compute and give to set(). Among the indexes not yet claimed,
+   * only the maxNbPending ones following the values merged into the value of index 0 can be
+   * claimed, the first of them in the claim order being returned. Blocks until the value of index 0
+   * absorbs the next value if none can be claimed, so the values computed or waiting to be merged
+   * are never more than maxNbPending.
+   * Call it at most once per value.
+   */
+  [[nodiscard]] std::size_t claim() {
+    std::unique_lock lock { m_mutex };
+    assert(m_nbClaimed < m_nbValues and "every value is already claimed");
+
+    while (true) {
+      std::optional<std::size_t> oClaimed;
+
+      for (auto i { m_mergedEnd }; i < std::min(m_nbValues, m_mergedEnd + m_maxNbPending); ++i) {
+        if (!m_isClaimed[i] and (!oClaimed.has_value() or m_claimRanks[i] < m_claimRanks[oClaimed.value()])) { oClaimed = i; }
+      }
+
+      if (oClaimed.has_value()) {
+        m_isClaimed[oClaimed.value()] = true;
+        ++m_nbClaimed;
+        return oClaimed.value();
+      }
+
+      // the value at m_mergedEnd is claimed, so it is being computed and will be merged
+      m_mergedEndChanged.wait(lock);
+    }
+  }
+
+  /**
+   * Gives the value of the given index, each index being given once.
+   */
+  void set(std::size_t index, T value) {
+    assert(index < m_nbValues and "index out of range");
+    auto start { index };
+    auto end { index + 1 };
+
+    while (true) {
+      std::optional<Run> oLeft;
+      std::optional<Run> oRight;
+      std::size_t leftStart { 0 };
+      {
+        const std::lock_guard lock { m_mutex };
+
+        if (const auto it { m_runs.find(end) }; m_runs.end() != it) {
+          oRight.emplace(std::move(it->second));
+          m_runs.erase(it);
+        }
+
+        if (const auto it { m_runs.lower_bound(start) }; m_runs.begin() != it and start == std::prev(it)->second.end) {
+          leftStart = std::prev(it)->first;
+          oLeft.emplace(std::move(std::prev(it)->second));
+          m_runs.erase(std::prev(it));
+        }
+
+        if (!oLeft.has_value() and !oRight.has_value()) {
+          m_runs.emplace(start, Run { .end = end, .value = std::move(value) });
+
+          if (0 == start) {
+            m_mergedEnd = end;
+            m_mergedEndChanged.notify_all();
+          }
+
+          return;
+        }
+      } // the neighbours taken out of m_runs belong to this thread, merged without the lock
+
+      if (oLeft.has_value()) {
+        m_merge(oLeft->value, std::move(value));
+        value = std::move(oLeft->value);
+        start = leftStart;
+      }
+
+      if (oRight.has_value()) {
+        m_merge(value, std::move(oRight->value));
+        end = oRight->end;
+      }
+    }
+  }
+
+  /**
+   * @returns the merge of all the values, once every index was given its value.
+   */
+  [[nodiscard]] T take() {
+    const std::lock_guard lock { m_mutex };
+
+    if (0 == m_nbValues) { return T {}; }
+
+    assert(1 == m_runs.size() and m_nbValues == m_runs.begin()->second.end and "values missing");
+    auto ret { std::move(m_runs.begin()->second.value) };
+    m_runs.clear();
+    return ret;
+  }
+}; // class OrderedReducer
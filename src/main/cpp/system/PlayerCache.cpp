@@ -49,7 +49,11 @@ void PlayerCache::erase(std::string_view playerName) {
 
 void PlayerCache::addIfMissing(std::string_view playerName) {
   const std::lock_guard lock { m_mutex };
-  m_players.emplace(std::make_pair(playerName, std::make_unique<Player>(Player::Params{ .name = playerName, .site = m_siteName })));
+
+  // a known player is seen at each hand, so don't create a Player to discard it
+  if (!m_players.contains(playerName)) {
+    m_players.emplace(std::make_pair(playerName, std::make_unique<Player>(Player::Params{ .name = playerName, .site = m_siteName })));
+  }
 }
 
 bool PlayerCache::isEmpty() {
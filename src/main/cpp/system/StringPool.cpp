@@ -0,0 +1,183 @@
+module;
+
+export module system.StringPool;
+
+#pragma warning( push )
+#pragma warning( disable : 4686)
+import std;
+#pragma warning( pop )
+
+/**
+ * A handle on an interned string, such as a hand id or a table name. StringId::empty is the empty string.
+ */
+export enum class /*[[nodiscard]]*/ StringId : std::uint32_t { empty = 0 };
+
+/**
+ * A handle on an interned player name. PlayerId::none is the empty name.
+ */
+export enum class /*[[nodiscard]]*/ PlayerId : std::uint32_t { none = 0 };
+
+/**
+ * A process wide pool of strings, each stored once. Interning the same string twice gives the
+ * same id, so ids can be compared instead of strings. The interned strings are never freed.
+ * All the functions are thread safe.
+ */
+export namespace stringPool {
+[[nodiscard]] StringId intern(std::string_view s);
+
+[[nodiscard]] inline PlayerId internPlayer(std::string_view playerName) {
+  return static_cast<PlayerId>(std::to_underlying(intern(playerName)));
+}
+
+/**
+ * @returns the id of the string if it was interned, without interning it.
+ */
+[[nodiscard]] std::optional<StringId> find(std::string_view s);
+
+[[nodiscard]] inline std::optional<PlayerId> findPlayer(std::string_view playerName) {
+  return find(playerName).transform([](StringId id) { return static_cast<PlayerId>(std::to_underlying(id)); });
+}
+
+/**
+ * @returns a view on the string, valid until the end of the program.
+ */
+[[nodiscard]] std::string_view view(StringId id) noexcept;
+
+[[nodiscard]] inline std::string_view view(PlayerId id) noexcept {
+  return view(static_cast<StringId>(std::to_underlying(id)));
+}
+
+[[nodiscard]] std::size_t getNbStrings() noexcept;
+
+/**
+ * @returns the number of characters stored.
+ */
+[[nodiscard]] std::size_t getNbBytes() noexcept;
+} // namespace stringPool
+
+module : private;
+
+static constexpr std::size_t NB_SHARDS { 16 }; // a power of 2
+static constexpr std::size_t CHUNK_SIZE { 4096 }; // views per chunk
+static constexpr std::size_t NB_MAX_CHUNKS { 4096 };
+static constexpr std::size_t BLOCK_SIZE { 64 * 1024 }; // characters per block
+
+// the strings whose hash falls in this shard, with their ids
+struct [[nodiscard]] Shard final {
+  std::shared_mutex m_mutex {};
+  std::unordered_map<std::string_view, std::uint32_t> m_ids {};
+  std::vector<std::unique_ptr<char[]>> m_blocks {};
+  std::size_t m_blockUsed { BLOCK_SIZE };
+
+  // copies s into the blocks, to be called with the mutex locked
+  [[nodiscard]] std::string_view store(std::string_view s) {
+    if (s.size() > BLOCK_SIZE) {
+      // a block of its own, inserted before the current block so that it stays the last one
+      auto pBlock { std::make_unique_for_overwrite<char[]>(s.size()) };
+      std::ranges::copy(s, pBlock.get());
+      const std::string_view ret { pBlock.get(), s.size() };
+      m_blocks.insert(m_blocks.empty() ? m_blocks.end() : std::prev(m_blocks.end()), std::move(pBlock));
+      return ret;
+    }
+
+    if (s.size() > BLOCK_SIZE - m_blockUsed) {
+      m_blocks.push_back(std::make_unique_for_overwrite<char[]>(BLOCK_SIZE));
+      m_blockUsed = 0;
+    }
+
+    const auto ret { m_blocks.back().get() + m_blockUsed };
+    std::ranges::copy(s, ret);
+    m_blockUsed += s.size();
+    return { ret, s.size() };
+  }
+}; // struct Shard
+
+class [[nodiscard]] Pool final {
+private:
+  std::array<Shard, NB_SHARDS> m_shards {};
+  // id -> string, by chunks that are never moved, so that view() does not lock
+  std::array<std::atomic<const std::string_view*>, NB_MAX_CHUNKS> m_chunks {};
+  std::array<std::unique_ptr<std::string_view[]>, NB_MAX_CHUNKS> m_chunkOwners {};
+  std::mutex m_chunksMutex {};
+  std::atomic_uint32_t m_nextId { 1 };
+  std::atomic_size_t m_nbBytes { 0 };
+
+  [[nodiscard]] std::string_view& getSlot(std::uint32_t id) {
+    const auto chunkIndex { id / CHUNK_SIZE };
+
+    if (chunkIndex >= NB_MAX_CHUNKS) { throw std::length_error("too many interned strings"); }
+
+    if (nullptr == m_chunks[chunkIndex].load(std::memory_order_acquire)) {
+      const std::lock_guard lock { m_chunksMutex };
+
+      if (nullptr == m_chunkOwners[chunkIndex]) {
+        m_chunkOwners[chunkIndex] = std::make_unique<std::string_view[]>(CHUNK_SIZE);
+        m_chunks[chunkIndex].store(m_chunkOwners[chunkIndex].get(), std::memory_order_release);
+      }
+    }
+
+    return m_chunkOwners[chunkIndex][id % CHUNK_SIZE];
+  }
+
+  [[nodiscard]] Shard& getShard(std::string_view s) noexcept {
+    return m_shards[std::hash<std::string_view> {}(s) & (NB_SHARDS - 1)];
+  }
+
+public:
+  [[nodiscard]] std::optional<std::uint32_t> find(std::string_view s) {
+    auto& shard { getShard(s) };
+    const std::shared_lock lock { shard.m_mutex };
+
+    if (const auto it { shard.m_ids.find(s) }; shard.m_ids.end() != it) { return it->second; }
+
+    return {};
+  }
+
+  [[nodiscard]] std::uint32_t intern(std::string_view s) {
+    if (const auto oId { find(s) }; oId.has_value()) { return oId.value(); }
+
+    auto& shard { getShard(s) };
+    const std::unique_lock lock { shard.m_mutex };
+
+    if (const auto it { shard.m_ids.find(s) }; shard.m_ids.end() != it) { return it->second; }
+
+    const auto stored { shard.store(s) };
+    const auto ret { m_nextId.fetch_add(1, std::memory_order_relaxed) };
+    // the slot is written before the id is published through the shard
+    getSlot(ret) = stored;
+    shard.m_ids.emplace(stored, ret);
+    m_nbBytes.fetch_add(s.size(), std::memory_order_relaxed);
+    return ret;
+  }
+
+  [[nodiscard]] std::string_view view(std::uint32_t id) const noexcept {
+    const auto pChunk { m_chunks[id / CHUNK_SIZE].load(std::memory_order_acquire) };
+    return pChunk[id % CHUNK_SIZE];
+  }
+
+  [[nodiscard]] std::size_t getNbStrings() const noexcept { return m_nextId.load(std::memory_order_relaxed) - 1; }
+  [[nodiscard]] std::size_t getNbBytes() const noexcept { return m_nbBytes.load(std::memory_order_relaxed); }
+}; // class Pool
+
+[[nodiscard]] static Pool& getPool() {
+  static Pool pool;
+  return pool;
+}
+
+StringId stringPool::intern(std::string_view s) {
+  return s.empty() ? StringId::empty : static_cast<StringId>(getPool().intern(s));
+}
+
+std::optional<StringId> stringPool::find(std::string_view s) {
+  if (s.empty()) { return StringId::empty; }
+
+  return getPool().find(s).transform([](std::uint32_t id) { return static_cast<StringId>(id); });
+}
+
+std::string_view stringPool::view(StringId id) noexcept {
+  return StringId::empty == id ? std::string_view {} : getPool().view(std::to_underlying(id));
+}
+
+std::size_t stringPool::getNbStrings() noexcept { return getPool().getNbStrings(); }
+
+std::size_t stringPool::getNbBytes() noexcept { return getPool().getNbBytes(); }
@@ -6,23 +6,57 @@ module;
 
 export module system.TextFile;
 
+import system.LineScanner;
+import system.Logger;
+import system.MappedFile;
+
 #pragma warning( push )
 #pragma warning( disable : 4686)
 import std;
 #pragma warning( pop ) 
 
+/**
+ * How a TextFile accesses the file content.
+ * memoryMapped: the file is mapped in memory, lines are views on the mapping (no copy).
+ * inMemory: the file is copied into a string, lines are views on that string.
+ * streamed: the file is read by fixed-size chunks into a single buffer, whatever the file size.
+ */
+export enum class /*[[nodiscard]]*/ TextFileMode : short { memoryMapped, inMemory, streamed };
+
 /**
  * A text file reader.
+ * The current line is a view on the file content: in memoryMapped and inMemory modes it stays valid
+ * as long as the TextFile lives, in streamed mode it is only valid until the next call to next().
  */
 export class [[nodiscard]] TextFile final {
 private:
   std::filesystem::path m_file;
-  std::string m_line {};
+  std::unique_ptr<MappedFile> m_pMapping;
+  std::string m_ownedContent {};
+  std::ifstream m_stream {};
+  std::string_view m_content {};
+  std::string_view m_line {};
+  std::size_t m_position { 0 };
+  std::size_t m_peakBufferSize { 0 };
   int m_lineNb { 0 };
-  std::stringstream m_content;
+
+  bool refill();
 
 public:
-  explicit TextFile(const std::filesystem::path& file);
+  static constexpr std::size_t DEFAULT_CHUNK_SIZE { 64 * 1024 };
+
+  /**
+   * If the file can't be mapped, falls back to TextFileMode::inMemory.
+   * @param chunkSize the buffer size in streamed mode. The buffer only grows if a single line is
+   * longer than it.
+   */
+  explicit TextFile(const std::filesystem::path& file, TextFileMode mode = TextFileMode::memoryMapped,
+                    std::size_t chunkSize = DEFAULT_CHUNK_SIZE);
+
+  /**
+   * Reads the lines of content, a part of file already in memory. content must outlive this object.
+   */
+  TextFile(const std::filesystem::path& file, std::string_view content);
   // use only std::filesystem::path
   TextFile(auto file) = delete;
   // non copyable
@@ -44,15 +78,27 @@ public:
   [[nodiscard]] int getLineIndex() const noexcept;
   [[nodiscard]] std::string getFileName() const;
 
+  /**
+   * @returns the biggest number of bytes of file content this object held in its own memory.
+   * 0 in memoryMapped mode, as the mapped pages belong to the system file cache.
+   */
+  [[nodiscard]] std::size_t getPeakBufferSize() const noexcept;
+
+  /**
+   * @returns the whole text read by this object, or an empty view in streamed mode as it never holds
+   * the whole text. The view is valid as long as this object lives.
+   */
+  [[nodiscard]] std::string_view getContent() const noexcept { return m_stream.is_open() ? std::string_view() : m_content; }
+
   /**
    * @returns the filename without extension.
    */
   [[nodiscard]] std::string getFileStem() const;
 
   /**
-   * @returns the current line of text.
+   * @returns the current line of text, without its end of line character(s).
    */
-  [[nodiscard]] std::string getLine() const noexcept;
+  [[nodiscard]] std::string_view getLine() const noexcept;
   [[nodiscard]] std::size_t find(std::string_view s) const noexcept;
   [[nodiscard]] std::size_t find(char c) const noexcept;
   [[nodiscard]] bool lineIsEmpty() const noexcept;
@@ -84,9 +130,9 @@ template<typename T> requires(std::same_as<T, std::filesystem::path>)
 // use std::filesystem::path as std needs it
 std::string readToString(const std::filesystem::path& p) {
   assert((!isDir(p)) and "given a dir instead of a file");
-  std::println("{}", p.string());
+  logger::debug(LogCategory::file, "Reading {} in memory.", p.string());
   assert((isFile(p)) and "given a non existing file");
-  std::ifstream in { p };
+  std::ifstream in { p, std::ios::binary };
   // decltype(std::ifstream::gcount()) is std::streamsize, which is signed.
   // std::string constructor takes a std::string::size_type, which is unsigned.
   // we know that std::ifstream::gcount() is always positive
@@ -97,16 +143,84 @@ std::string readToString(const std::filesystem::path& p) {
   return result;
 }
 
-TextFile::TextFile(const std::filesystem::path& file)
+[[nodiscard]] std::unique_ptr<MappedFile> mapIfAsked(const std::filesystem::path& file, TextFileMode mode) {
+  if (TextFileMode::memoryMapped != mode) { return nullptr; }
+
+  auto ret { std::make_unique<MappedFile>(file) };
+  return ret->isMapped() ? std::move(ret) : nullptr;
+}
+
+TextFile::TextFile(const std::filesystem::path& file, TextFileMode mode, std::size_t chunkSize)
   : m_file { file },
-    m_content { readToString(file) } {}
+    m_pMapping { mapIfAsked(file, mode) } {
+  assert((0 < chunkSize) and "the chunk size must be positive");
+
+  if (nullptr != m_pMapping) {
+    m_content = m_pMapping->view();
+  } else if (TextFileMode::streamed == mode) {
+    m_stream.open(file, std::ios::binary);
+    m_ownedContent.resize(chunkSize);
+    m_peakBufferSize = chunkSize;
+  } else {
+    m_ownedContent = readToString(file);
+    m_content = m_ownedContent;
+    m_peakBufferSize = m_ownedContent.size();
+  }
+}
+
+TextFile::TextFile(const std::filesystem::path& file, std::string_view content)
+  : m_file { file },
+    m_pMapping { nullptr },
+    m_content { content } {}
+
+// streamed mode: keeps the unread bytes at the start of the buffer and fills the rest with the
+// next chunk of the file.
+// @returns false if nothing more could be read.
+bool TextFile::refill() {
+  if (!m_stream.is_open() or m_stream.eof()) { return false; }
+
+  const auto remaining { m_content.size() - m_position };
+
+  if (0 < m_position) {
+    std::copy(m_content.begin() + gsl::narrow_cast<std::ptrdiff_t>(m_position), m_content.end(),
+              m_ownedContent.begin());
+  } else if (remaining == m_ownedContent.size()) { // a single line does not fit in the buffer
+    m_ownedContent.resize(2 * m_ownedContent.size());
+    m_peakBufferSize = std::max(m_peakBufferSize, m_ownedContent.size());
+  }
+
+  m_stream.read(m_ownedContent.data() + remaining,
+                gsl::narrow_cast<std::streamsize>(m_ownedContent.size() - remaining));
+  const auto nbRead { gsl::narrow_cast<std::size_t>(m_stream.gcount()) };
+  m_content = std::string_view(m_ownedContent).substr(0, remaining + nbRead);
+  m_position = 0;
+  return 0 < nbRead;
+}
 
 bool TextFile::next() {
-  const auto ret { !std::getline(m_content, m_line).fail() };
+  auto searchFrom { m_position };
+  auto endOfLine { lineScanner::findNewline(m_content, searchFrom) };
+
+  while (std::string_view::npos == endOfLine) {
+    // the bytes already scanned are moved to the start of the buffer by refill()
+    searchFrom = m_content.size() - m_position;
+
+    if (!refill()) { break; }
+
+    endOfLine = lineScanner::findNewline(m_content, searchFrom);
+  }
+
+  if (m_content.size() <= m_position) { return false; }
+
+  const auto lineEnd { std::string_view::npos == endOfLine ? m_content.size() : endOfLine };
+  m_line = m_content.substr(m_position, lineEnd - m_position);
 
-  if (ret) { ++m_lineNb; }
+  // the file is read in binary mode, so remove the '\r' of Windows line endings
+  if (m_line.ends_with('\r')) { m_line.remove_suffix(1); }
 
-  return ret;
+  m_position = std::string_view::npos == endOfLine ? m_content.size() : endOfLine + 1;
+  ++m_lineNb;
+  return true;
 }
 
 template<typename CONTAINER, typename PREDICATE>
@@ -152,9 +266,10 @@ bool TextFile::containsExact(std::string_view s) const noexcept {
 }
 
 int TextFile::getLineIndex() const noexcept { return m_lineNb; }
+std::size_t TextFile::getPeakBufferSize() const noexcept { return m_peakBufferSize; }
 std::string TextFile::getFileName() const { return m_file.string(); }
 std::string TextFile::getFileStem() const { return m_file.stem().string(); }
-std::string TextFile::getLine() const noexcept { return m_line; }
+std::string_view TextFile::getLine() const noexcept { return m_line; }
 std::size_t TextFile::find(std::string_view s) const noexcept { return m_line.find(s); }
 std::size_t TextFile::find(char c) const noexcept { return m_line.find(c); }
 bool TextFile::lineIsEmpty() const noexcept { return m_line.empty(); }
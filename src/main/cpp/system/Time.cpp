@@ -7,88 +7,143 @@ export module system.Time;
 import std;
 #pragma warning( pop )
 
+/**
+ * A point in time, to the second, considered UTC.
+ * Trivially copyable: it is a number of seconds since the epoch.
+ */
 export class [[nodiscard]] Time final {
 private:
-  std::unique_ptr<std::tm> m_pTimeData;
+  std::chrono::sys_seconds m_time;
 public:
+  /**
+   * The formats "%Y/%m/%d %H:%M:%S" and "%Y-%m-%d %H:%M:%S" (and any other separators at the same
+   * places) are parsed by a fixed offset parser, the other ones by std::get_time.
+   */
   struct [[nodiscard]] Params final { std::string_view strTime; std::string_view format; };
 
+  /**
+   * @throws std::string if args.strTime is not a valid time
+   */
   explicit Time(const Params& args);
-  Time(const Time& other) noexcept;
-  explicit Time(Time&& other) noexcept;
-  ~Time() = default;
-  [[nodiscard]] Time& operator=(const Time& other) noexcept;
-  [[nodiscard]] Time& operator=(Time&& other) noexcept;
-  [[nodiscard]] bool operator==(const Time& other) const noexcept;
+  explicit constexpr Time(std::chrono::sys_seconds time) noexcept : m_time { time } {}
+
+  /**
+   * @returns the time, or std::nullopt if args.strTime is not a valid time. For the parsers that
+   * must not throw on malformed input.
+   */
+  [[nodiscard]] static std::optional<Time> parse(const Params& args);
+
+  [[nodiscard]] bool operator==(const Time& other) const noexcept = default;
   [[nodiscard]] std::string toSqliteDate() const;
+
+  /**
+   * @returns the time as a number of seconds since the epoch, the time being considered UTC.
+   */
+  [[nodiscard]] constexpr std::chrono::sys_seconds toSysSeconds() const noexcept { return m_time; }
 }; // class Time
 
-static constexpr std::string_view SQLITE_DATE_FORMAT { "%Y-%m-%d %H:%M:%S" };
+export constexpr std::string_view SQLITE_DATE_FORMAT { "%Y-%m-%d %H:%M:%S" };
 
 module : private;
 
-[[nodiscard]] std::tm toTm(const Time::Params& args) {
-  std::tm when {.tm_sec = 0, .tm_min = 0, .tm_hour = 0, .tm_mday = 0,
-                .tm_mon = 0, .tm_year = 0, .tm_wday = 0, .tm_yday = 0,
-                .tm_isdst = 0 };
-  std::istringstream iss { args.strTime.data() };
-  iss >> std::get_time(&when, args.format.data());
+static_assert(std::is_trivially_copyable_v<Time>);
+
+[[nodiscard]] static std::optional<std::chrono::sys_seconds> toSysSeconds(int year, unsigned month, unsigned day,
+    int hour, int minute, int second) noexcept {
+  const std::chrono::year_month_day date { std::chrono::year { year }, std::chrono::month { month },
+                                           std::chrono::day { day } };
 
-  if (iss.fail()) {
-    throw std::format("The string '{}' is not a valid time.", args.strTime);
-  }
+  // no leap second: sys_seconds ignores them, so 60 would roll over to the next minute
+  if (!date.ok() or 23 < hour or 59 < minute or 59 < second) { return {}; }
 
-  return when;
+  return std::chrono::sys_days { date } + std::chrono::hours { hour } + std::chrono::minutes { minute }
+         + std::chrono::seconds { second };
 }
 
-Time::Time(const Params& args)
-  : m_pTimeData { std::make_unique<std::tm>(toTm(args)) } {
-  // nothing to do
+// "%Y?%m?%d?%H?%M?%S", '?' being any separator
+[[nodiscard]] static constexpr bool isFixedFormat(std::string_view format) noexcept {
+  return 17 == format.size() and format.substr(0, 2) == "%Y" and format.substr(3, 2) == "%m"
+         and format.substr(6, 2) == "%d" and format.substr(9, 2) == "%H" and format.substr(12, 2) == "%M"
+         and format.substr(15, 2) == "%S";
 }
 
-Time::Time(const Time& other) noexcept
-  : m_pTimeData { std::make_unique<std::tm>() } {
-  *m_pTimeData = *other.m_pTimeData;
+// the offsets in the parsed string of the separators of a fixed format, and of the format ones
+static constexpr std::array<std::size_t, 5> TIME_SEPARATOR_POSITIONS { 4, 7, 10, 13, 16 };
+static constexpr std::array<std::size_t, 5> FORMAT_SEPARATOR_POSITIONS { 2, 5, 8, 11, 14 };
+
+// parses the given digits without checking them
+[[nodiscard]] static constexpr int toInt(std::string_view digits) noexcept {
+  int ret { 0 };
+
+  for (const auto c : digits) { ret = ret * 10 + (c - '0'); }
+
+  return ret;
 }
 
-Time::Time(Time&& other) noexcept
-  : m_pTimeData { std::exchange(other.m_pTimeData, {}) } {
-  // nothing to do
+// ex: "2014/10/31 00:45:01"
+[[nodiscard]] static std::optional<std::chrono::sys_seconds> parseFixedFormat(const Time::Params& args) noexcept {
+  const auto s { args.strTime };
+  const auto isValid { [&]() noexcept {
+      if (19 != s.size()) { return false; }
+
+      for (std::size_t i { 0 }; i < TIME_SEPARATOR_POSITIONS.size(); ++i) {
+        if (s[TIME_SEPARATOR_POSITIONS[i]] != args.format[FORMAT_SEPARATOR_POSITIONS[i]]) { return false; }
+      }
+
+      for (std::size_t i { 0 }; i < s.size(); ++i) {
+        if (std::ranges::find(TIME_SEPARATOR_POSITIONS, i) == TIME_SEPARATOR_POSITIONS.end()
+            and (s[i] < '0' or '9' < s[i])) { return false; }
+      }
+
+      return true;
+    } };
+
+  if (!isValid()) { return {}; }
+
+  return toSysSeconds(toInt(s.substr(0, 4)), static_cast<unsigned>(toInt(s.substr(5, 2))),
+                      static_cast<unsigned>(toInt(s.substr(8, 2))), toInt(s.substr(11, 2)), toInt(s.substr(14, 2)),
+                      toInt(s.substr(17, 2)));
 }
 
-[[nodiscard]] Time& Time::operator=(const Time& other) noexcept {
-  if (this != &other) {
-    m_pTimeData = std::make_unique<std::tm>();
-    *m_pTimeData = *other.m_pTimeData;
-  }
+[[nodiscard]] static std::optional<std::chrono::sys_seconds> parseWithGetTime(const Time::Params& args) {
+  std::tm when {.tm_sec = 0, .tm_min = 0, .tm_hour = 0, .tm_mday = 0,
+                .tm_mon = 0, .tm_year = 0, .tm_wday = 0, .tm_yday = 0,
+                .tm_isdst = 0 };
+  // strTime may be a view on a bigger text, such as a mapped file, so copy it. get_time stops
+  // without failing at the end of a truncated time, so the time is followed by an end mark that
+  // must be all that is left once the whole format is read.
+  static constexpr char END_MARK { '\x01' };
+  std::istringstream iss { std::string(args.strTime) + END_MARK };
+  // get_time needs a null terminated format
+  iss >> std::get_time(&when, std::string(args.format).c_str());
+
+  if (iss.fail() or END_MARK != iss.get() or std::istringstream::traits_type::eof() != iss.peek()) { return {}; }
+
+  return toSysSeconds(when.tm_year + 1900, static_cast<unsigned>(when.tm_mon + 1), static_cast<unsigned>(when.tm_mday),
+                      when.tm_hour, when.tm_min, when.tm_sec);
+}
 
-  return *this;
+[[nodiscard]] static std::optional<std::chrono::sys_seconds> parseSysSeconds(const Time::Params& args) {
+  return isFixedFormat(args.format) ? parseFixedFormat(args) : parseWithGetTime(args);
 }
 
-[[nodiscard]] Time& Time::operator=(Time&& other) noexcept {
-  if (this != &other) {
-    m_pTimeData = std::exchange(other.m_pTimeData, {});
-  }
+[[nodiscard]] static std::chrono::sys_seconds toSysSecondsOrThrow(const Time::Params& args) {
+  if (const auto oTime { parseSysSeconds(args) }; oTime.has_value()) { return oTime.value(); }
+
+  throw std::format("The string '{}' is not a valid time.", args.strTime);
+}
 
-  return *this;
+Time::Time(const Params& args) : m_time { toSysSecondsOrThrow(args) } {
+  // nothing to do
 }
 
-[[nodiscard]] bool Time::operator==(const Time& other) const noexcept {
-  return this == &other ? true :
-         m_pTimeData->tm_sec == other.m_pTimeData->tm_sec
-         and m_pTimeData->tm_min == other.m_pTimeData->tm_min
-         and m_pTimeData->tm_hour == other.m_pTimeData->tm_hour
-         and m_pTimeData->tm_mday == other.m_pTimeData->tm_mday
-         and m_pTimeData->tm_mon == other.m_pTimeData->tm_mon
-         and m_pTimeData->tm_year == other.m_pTimeData->tm_year
-         and m_pTimeData->tm_wday == other.m_pTimeData->tm_wday
-         and m_pTimeData->tm_yday == other.m_pTimeData->tm_yday
-         and m_pTimeData->tm_isdst == other.m_pTimeData->tm_isdst;
+std::optional<Time> Time::parse(const Params& args) {
+  if (const auto oTime { parseSysSeconds(args) }; oTime.has_value()) { return Time { oTime.value() }; }
+
+  return {};
 }
 
 [[nodiscard]] std::string Time::toSqliteDate() const {
   // "2014-10-31 00:45:01"
-  std::ostringstream oss;
-  oss << std::put_time(m_pTimeData.get(), SQLITE_DATE_FORMAT.data());
-  return oss.str();
-}
\ No newline at end of file
+  return std::format("{:%Y-%m-%d %H:%M:%S}", m_time);
+}
@@ -0,0 +1,124 @@
+module;
+
+export module system.WorkStealingExecutor;
+
+#pragma warning( push )
+#pragma warning( disable : 4686)
+import std;
+#pragma warning( pop )
+
+/**
+ * Runs a fixed set of jobs on a fixed number of threads.
+ * The jobs are dealt to the workers in the given order, so each worker starts with the first jobs
+ * it was given. A worker without jobs left steals the last job of another worker, so no worker is
+ * idle while jobs are waiting. A job that throws does not stop the other jobs: its exception is kept
+ * for wait().
+ */
+export class [[nodiscard]] WorkStealingExecutor final {
+private:
+  struct [[nodiscard]] Worker final {
+    std::mutex m_mutex {};
+    std::deque<std::function<void()>> m_jobs {};
+  };
+
+  std::vector<Worker> m_workers;
+  std::mutex m_exceptionMutex {};
+  std::exception_ptr m_pException {}; // the first exception thrown by a job
+  std::vector<std::jthread> m_threads {}; // last member, so that the threads stop before the workers are destroyed
+
+  [[nodiscard]] std::optional<std::function<void()>> takeOwnJob(std::size_t workerIndex);
+  [[nodiscard]] std::optional<std::function<void()>> stealJob(std::size_t thiefIndex);
+  void work(std::size_t workerIndex);
+
+public:
+  /**
+   * Starts running the jobs.
+   * @param nbWorkers the number of threads, 0 meaning one per hardware thread
+   */
+  WorkStealingExecutor(std::vector<std::function<void()>> jobs, std::size_t nbWorkers);
+  WorkStealingExecutor(const WorkStealingExecutor&) = delete;
+  WorkStealingExecutor(WorkStealingExecutor&&) = delete;
+  WorkStealingExecutor& operator=(const WorkStealingExecutor&) = delete;
+  WorkStealingExecutor& operator=(WorkStealingExecutor&&) = delete;
+
+  /**
+   * Waits for all the jobs to be done.
+   * @throws the first exception thrown by a job, if any
+   */
+  void wait();
+
+  /**
+   * Waits for all the jobs to be done. The exceptions of the jobs are lost if wait() was not called.
+   */
+  ~WorkStealingExecutor() = default;
+
+  [[nodiscard]] static std::size_t toNbWorkers(std::size_t nbWorkers) noexcept {
+    return 0 == nbWorkers ? std::max<std::size_t>(1, std::thread::hardware_concurrency()) : nbWorkers;
+  }
+}; // class WorkStealingExecutor
+
+module : private;
+
+WorkStealingExecutor::WorkStealingExecutor(std::vector<std::function<void()>> jobs,
+    std::size_t nbWorkers)
+  : m_workers(std::min(toNbWorkers(nbWorkers), std::max<std::size_t>(1, jobs.size()))) {
+  for (std::size_t i { 0 }; i < jobs.size(); ++i) {
+    m_workers[i % m_workers.size()].m_jobs.push_back(std::move(jobs[i]));
+  }
+
+  m_threads.reserve(m_workers.size());
+
+  for (std::size_t i { 0 }; i < m_workers.size(); ++i) { m_threads.emplace_back([this, i]() { work(i); }); }
+}
+
+std::optional<std::function<void()>> WorkStealingExecutor::takeOwnJob(std::size_t workerIndex) {
+  auto& worker { m_workers[workerIndex] };
+  const std::lock_guard lock { worker.m_mutex };
+
+  if (worker.m_jobs.empty()) { return {}; }
+
+  auto ret { std::move(worker.m_jobs.front()) };
+  worker.m_jobs.pop_front();
+  return ret;
+}
+
+std::optional<std::function<void()>> WorkStealingExecutor::stealJob(std::size_t thiefIndex) {
+  for (std::size_t i { 1 }; i < m_workers.size(); ++i) {
+    auto& victim { m_workers[(thiefIndex + i) % m_workers.size()] };
+    const std::lock_guard lock { victim.m_mutex };
+
+    if (!victim.m_jobs.empty()) {
+      auto ret { std::move(victim.m_jobs.back()) };
+      victim.m_jobs.pop_back();
+      return ret;
+    }
+  }
+
+  return {};
+}
+
+// no job is added once the workers are started, so a worker that finds no job is done
+void WorkStealingExecutor::work(std::size_t workerIndex) {
+  while (true) {
+    auto oJob { takeOwnJob(workerIndex) };
+
+    if (!oJob.has_value()) { oJob = stealJob(workerIndex); }
+
+    if (!oJob.has_value()) { return; }
+
+    try {
+      oJob.value()();
+    } catch (...) {
+      const std::lock_guard lock { m_exceptionMutex };
+
+      if (nullptr == m_pException) { m_pException = std::current_exception(); }
+    }
+  }
+}
+
+void WorkStealingExecutor::wait() {
+  std::ranges::for_each(m_threads, [](std::jthread & t) { if (t.joinable()) { t.join(); } });
+
+  // the threads are joined, so the exception can't change any more
+  if (nullptr != m_pException) { std::rethrow_exception(m_pException); }
+}
@@ -23,6 +23,12 @@ export namespace prm::system::filesystem {
  */
 [[nodiscard]] std::vector<std::filesystem::path> listSubDirs(const std::filesystem::path&
     dir);
+
+/**
+ * @returns the directory where the applications of the current user keep their cache files, or an
+ * empty path if it is unknown.
+ */
+[[nodiscard]] std::filesystem::path getUserCacheDir();
 } // namespace prm::system::filesystem
 
 module : private;
@@ -75,6 +81,21 @@ std::vector<std::filesystem::path> prm::system::filesystem::listSubDirs(const st
   return allFilesAndDirs;
 }
 
+std::filesystem::path prm::system::filesystem::getUserCacheDir() {
+#if defined(_WIN32)
+  const auto* localAppData { std::getenv("LOCALAPPDATA") };
+  return (nullptr == localAppData) ? std::filesystem::path() : std::filesystem::path(localAppData);
+#else
+
+  if (const auto* xdgCacheHome { std::getenv("XDG_CACHE_HOME") }; nullptr != xdgCacheHome and '\0' != *xdgCacheHome) {
+    return xdgCacheHome;
+  }
+
+  const auto* home { std::getenv("HOME") };
+  return (nullptr == home or '\0' == *home) ? std::filesystem::path() : std::filesystem::path(home) / ".cache";
+#endif // _WIN32
+}
+
 std::vector<std::filesystem::path> prm::system::filesystem::listTxtFilesInDir(
   const std::filesystem::path& dir) {
   auto allFilesAndDirs { listFilesAndDirs(dir) };
@@ -0,0 +1,135 @@
+module;
+
+#include <boost/test/unit_test.hpp>
+
+export module test.entities.Card;
+
+import entities.Card;
+
+import std;
+
+static constexpr std::string_view RANKS { "23456789TJQKA" };
+static constexpr std::string_view SUITS { "shdc" }; // in the Card order
+
+[[nodiscard]] static CardSet toCardSet(std::initializer_list<std::string_view> strCards) {
+  std::vector<Card> cards;
+  std::ranges::transform(strCards, std::back_inserter(cards), [](auto strCard) { return toCard(strCard); });
+  return CardSet(cards);
+}
+
+BOOST_AUTO_TEST_SUITE(CardTest)
+
+BOOST_AUTO_TEST_CASE(CardTest_shouldDecodeEveryRankAndSuit) {
+  for (std::size_t suit { 0 }; suit < SUITS.size(); ++suit) {
+    for (std::size_t rank { 0 }; rank < RANKS.size(); ++rank) {
+      const std::string strCard { RANKS[rank], SUITS[suit] };
+      const auto expected { static_cast<Card>(1 + suit * RANKS.size() + rank) };
+      BOOST_REQUIRE_MESSAGE(expected == toCard(RANKS[rank], SUITS[suit]), strCard);
+      BOOST_REQUIRE_MESSAGE(expected == toCard(strCard), strCard);
+      BOOST_REQUIRE_MESSAGE(strCard == toString(expected), strCard);
+    }
+  }
+
+  BOOST_REQUIRE(Card::none == toCard("none"));
+  BOOST_REQUIRE(Card::back == toCard("back"));
+  BOOST_REQUIRE("none" == toString(Card::none));
+  BOOST_REQUIRE("back" == toString(Card::back));
+}
+
+BOOST_AUTO_TEST_CASE(CardTest_shouldGiveNoneForUnknownChars) {
+  for (int i { std::numeric_limits<char>::min() }; i <= std::numeric_limits<char>::max(); ++i) {
+    const auto c { static_cast<char>(i) };
+
+    if (RANKS.find(c) == std::string_view::npos) { BOOST_REQUIRE_MESSAGE(Card::none == toCard(c, 's'), i); }
+
+    if (SUITS.find(c) == std::string_view::npos) { BOOST_REQUIRE_MESSAGE(Card::none == toCard('A', c), i); }
+  }
+
+  // the names are case sensitive
+  BOOST_REQUIRE(Card::none == toCard('t', 's'));
+  BOOST_REQUIRE(Card::none == toCard('A', 'S'));
+
+  for (const auto strCard : { "", "A", "1s", "As ", "AsK", "Ax", "NONE", "Back" }) {
+    BOOST_REQUIRE_THROW(std::ignore = toCard(strCard), std::range_error);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(CardTest_cardSetShouldIgnoreNoneAndBack) {
+  CardSet set { std::array { Card::none, Card::back } };
+  BOOST_REQUIRE(set.empty());
+  BOOST_REQUIRE(0 == set.size());
+  set.add(Card::aceSpade);
+  set.add(Card::none);
+  set.add(Card::back);
+  BOOST_REQUIRE(1 == set.size());
+  BOOST_REQUIRE(set.contains(Card::aceSpade));
+  BOOST_REQUIRE(!set.contains(Card::none));
+  BOOST_REQUIRE(!set.contains(Card::back));
+  BOOST_REQUIRE(CardSet(std::array { Card::aceSpade }) == set);
+  // a board not dealt yet
+  const CardSet hidden { std::array { Card::back, Card::back, Card::back, Card::none, Card::none } };
+  BOOST_REQUIRE(hidden.empty());
+  BOOST_REQUIRE(!hidden.isPaired());
+  BOOST_REQUIRE(!hidden.isFlushPossible());
+}
+
+BOOST_AUTO_TEST_CASE(CardTest_cardSetShouldContainEachCardOnce) {
+  CardSet set;
+
+  for (auto i { std::to_underlying(Card::twoSpade) }; i <= std::to_underlying(Card::aceClub); ++i) {
+    set.add(static_cast<Card>(i));
+    set.add(static_cast<Card>(i));
+    BOOST_REQUIRE(i == set.size());
+  }
+
+  BOOST_REQUIRE(52 == std::popcount(set.getMask()));
+  BOOST_REQUIRE(13 == set.getMaxNbCardsOfASuit());
+}
+
+BOOST_AUTO_TEST_CASE(CardTest_shouldGiveTheMaxNbCardsOfASuit) {
+  BOOST_REQUIRE(0 == CardSet().getMaxNbCardsOfASuit());
+  BOOST_REQUIRE(1 == toCardSet({ "2s", "3h", "4d", "5c" }).getMaxNbCardsOfASuit());
+  BOOST_REQUIRE(2 == toCardSet({ "As", "Ks", "Ah", "Ad", "Ac" }).getMaxNbCardsOfASuit());
+  // each suit in turn, at both ends of its bits
+  BOOST_REQUIRE(3 == toCardSet({ "2s", "7s", "As", "Kh" }).getMaxNbCardsOfASuit());
+  BOOST_REQUIRE(3 == toCardSet({ "2h", "7h", "Ah", "Ks" }).getMaxNbCardsOfASuit());
+  BOOST_REQUIRE(3 == toCardSet({ "2d", "7d", "Ad", "Kc" }).getMaxNbCardsOfASuit());
+  BOOST_REQUIRE(3 == toCardSet({ "2c", "7c", "Ac", "Kd" }).getMaxNbCardsOfASuit());
+  BOOST_REQUIRE(7 == toCardSet({ "2c", "3c", "4c", "5c", "6c", "7c", "8c" }).getMaxNbCardsOfASuit());
+}
+
+BOOST_AUTO_TEST_CASE(CardTest_shouldTellIfAFiveCardBoardIsPairedOrAllowsAFlush) {
+  const auto rainbow { toCardSet({ "2s", "7h", "Jd", "Kc", "As" }) };
+  BOOST_REQUIRE(!rainbow.isPaired());
+  BOOST_REQUIRE(!rainbow.isFlushPossible());
+  const auto flushDraw { toCardSet({ "2h", "7h", "Jd", "Kh", "As" }) };
+  BOOST_REQUIRE(!flushDraw.isPaired());
+  BOOST_REQUIRE(flushDraw.isFlushPossible());
+  const auto paired { toCardSet({ "2s", "2h", "Jd", "Kc", "As" }) };
+  BOOST_REQUIRE(paired.isPaired());
+  BOOST_REQUIRE(!paired.isFlushPossible());
+  const auto both { toCardSet({ "Ac", "7c", "Jd", "Kc", "As" }) };
+  BOOST_REQUIRE(both.isPaired());
+  BOOST_REQUIRE(both.isFlushPossible());
+  const auto quads { toCardSet({ "9s", "9h", "9d", "9c", "Ts" }) };
+  BOOST_REQUIRE(quads.isPaired());
+  BOOST_REQUIRE(!quads.isFlushPossible());
+}
+
+BOOST_AUTO_TEST_CASE(CardTest_shouldTellIfASevenCardBoardIsPairedOrAllowsAFlush) {
+  const auto twoOfEachSuit { toCardSet({ "2s", "3h", "4d", "5c", "6s", "7h", "8d" }) };
+  BOOST_REQUIRE(!twoOfEachSuit.isPaired());
+  BOOST_REQUIRE(!twoOfEachSuit.isFlushPossible());
+  const auto flush { toCardSet({ "2s", "3h", "4d", "5c", "6s", "7h", "8s" }) };
+  BOOST_REQUIRE(!flush.isPaired());
+  BOOST_REQUIRE(flush.isFlushPossible());
+  // the pair is made of the first and the last suit
+  const auto paired { toCardSet({ "As", "3h", "4d", "5c", "6s", "7h", "Ac" }) };
+  BOOST_REQUIRE(paired.isPaired());
+  BOOST_REQUIRE(!paired.isFlushPossible());
+  const auto both { toCardSet({ "Kd", "3d", "4d", "5c", "6s", "7h", "Kh" }) };
+  BOOST_REQUIRE(both.isPaired());
+  BOOST_REQUIRE(both.isFlushPossible());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
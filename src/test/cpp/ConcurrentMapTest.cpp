@@ -0,0 +1,51 @@
+module;
+
+#include <boost/test/unit_test.hpp>
+
+export module test.system.ConcurrentMap;
+
+import system.ConcurrentMap;
+
+import std;
+
+BOOST_AUTO_TEST_SUITE(ConcurrentMapTest)
+
+BOOST_AUTO_TEST_CASE(ConcurrentMapTest_insertOrCombineShouldCombineTheValuesOfAKey) {
+  ConcurrentMap<std::string, int> map;
+  BOOST_REQUIRE(!map.find("a").has_value());
+  map.insertOrCombine("a", 3, std::plus {});
+  BOOST_REQUIRE(3 == map.find("a"));
+  map.insertOrCombine("a", 4, std::plus {});
+  BOOST_REQUIRE(7 == map.find("a"));
+  map.insertOrCombine("b", 1, std::plus {});
+  BOOST_REQUIRE(1 == map.find("b"));
+  BOOST_REQUIRE(7 == map.find("a"));
+  BOOST_REQUIRE(!map.find("c").has_value());
+}
+
+BOOST_AUTO_TEST_CASE(ConcurrentMapTest_concurrentInsertsShouldKeepTheMinimumWhateverTheOrder) {
+  constexpr std::size_t NB_KEYS { 10'000 };
+  // each thread in another order, so that threads use the same keys at the same time: the
+  // strides are prime with the number of keys, so each thread uses all of them
+  constexpr std::array STRIDES { 1UZ, 3UZ, 7UZ, 9UZ, 11UZ, 13UZ, 17UZ, 19UZ };
+  ConcurrentMap<std::size_t, std::size_t> map;
+  {
+    std::vector<std::jthread> threads;
+
+    for (std::size_t t { 0 }; t < STRIDES.size(); ++t) {
+      threads.emplace_back([&map, t, stride = STRIDES[t]]() {
+        for (std::size_t i { 0 }; i < NB_KEYS; ++i) {
+          const auto key { i * stride % NB_KEYS };
+          // thread t gives key the value key + t, the minimum being key
+          map.insertOrCombine(key, key + t, [](std::size_t a, std::size_t b) { return std::min(a, b); });
+        }
+      });
+    }
+  }
+
+  for (std::size_t key { 0 }; key < NB_KEYS; ++key) { BOOST_REQUIRE(key == map.find(key)); }
+
+  BOOST_REQUIRE(!map.find(NB_KEYS).has_value());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,58 @@
+module;
+
+#include <boost/test/unit_test.hpp>
+
+export module test.entities.HandId;
+
+import entities.HandId;
+
+import std;
+
+BOOST_AUTO_TEST_SUITE(HandIdTest)
+
+BOOST_AUTO_TEST_CASE(HandIdTest_shouldParseTheWinamaxIds) {
+  const auto oId { HandId::parse("12266668-4174329-1549487680") };
+  BOOST_REQUIRE(oId.has_value());
+  BOOST_REQUIRE(12266668 == oId->getFirst());
+  BOOST_REQUIRE(4174329 == oId->getSecond());
+  BOOST_REQUIRE(1549487680 == oId->getThird());
+  BOOST_REQUIRE("12266668-4174329-1549487680" == oId->toString());
+  BOOST_REQUIRE(HandId::parse("0-0-0") == HandId {});
+  BOOST_REQUIRE(HandId::parse("9999999999999999999-4294967295-4294967295")
+                == HandId(9'999'999'999'999'999'999ULL, 4'294'967'295U, 4'294'967'295U));
+}
+
+BOOST_AUTO_TEST_CASE(HandIdTest_shouldRejectMalformedIds) {
+  for (const auto id : { "", "-", "1", "1-2", "1-2-", "1-2-3-", "1-2-3-4", "-1-2-3", "1--3", "1-2--3", " 1-2-3",
+                         "1-2-3 ", "1 -2-3", "1_2_3", "a-2-3", "1-b-3", "1-2-c", "1-2-3x", "+1-2-3", "1-2-0x3",
+                         "12345678901234567890-2-3", "1-4294967296-3", "1-2-4294967296", "1-2-99999999999999999999" }) {
+    BOOST_REQUIRE_MESSAGE(!HandId::parse(id).has_value(), id);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(HandIdTest_shouldBeOrderedByItsNumbers) {
+  // the numbers are compared, not the text: "1-10-0" is after "1-2-3"
+  const std::vector<std::string_view> sortedIds { "1-2-3", "1-2-30", "1-10-0", "2-0-0", "10-0-0",
+                                                  "12266668-4174329-1549487680", "12266668-4174330-1549487680" };
+  std::vector<HandId> ids;
+  std::ranges::transform(sortedIds, std::back_inserter(ids), [](auto id) { return HandId::parse(id).value(); });
+  BOOST_REQUIRE(std::ranges::is_sorted(ids));
+  BOOST_REQUIRE(ids.end() == std::ranges::adjacent_find(ids));
+  auto shuffled { ids };
+  std::ranges::reverse(shuffled);
+  std::ranges::rotate(shuffled, shuffled.begin() + 3);
+  std::ranges::sort(shuffled);
+  BOOST_REQUIRE(ids == shuffled);
+  BOOST_REQUIRE(HandId::parse("1-2-3") == HandId::parse("0001-02-003"));
+}
+
+BOOST_AUTO_TEST_CASE(HandIdTest_equalIdsShouldHaveTheSameHash) {
+  const auto id { HandId::parse("12266668-4174329-1549487680").value() };
+  BOOST_REQUIRE(std::hash<HandId> {}(id) == std::hash<HandId> {}(HandId { 12266668, 4174329, 1549487680 }));
+  const std::unordered_set<HandId> ids { id, HandId { 12266668, 4174329, 1549487681 }, HandId { 12266668, 4174330, 1549487680 },
+                                         HandId { 12266669, 4174329, 1549487680 }, id };
+  BOOST_REQUIRE(4 == ids.size());
+  BOOST_REQUIRE(ids.contains(HandId::parse("12266668-4174329-1549487680").value()));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
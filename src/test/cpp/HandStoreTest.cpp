@@ -0,0 +1,165 @@
+module;
+
+#include <boost/test/unit_test.hpp>
+
+export module test.history.HandStore;
+
+import entities.Action;
+import entities.Game;
+import entities.Hand;
+import entities.Site;
+import history.HandStore;
+import history.WinamaxGameHistory;
+import system.StringPool;
+
+import std;
+
+static const std::filesystem::path HISTORY_FILE { TEST_RESOURCES_DIR "20190206_Colorado_real_holdem_no-limit.txt" };
+static constexpr std::size_t NB_HANDS { 91 };
+
+// the file header: magic, version, number of hands, then the offset and size of each column
+static constexpr std::size_t NB_HANDS_OFFSET { 8 };
+static constexpr std::size_t COLUMNS_OFFSET { 16 };
+static constexpr std::size_t TABLE_NAMES_COLUMN { 2 };
+static constexpr std::size_t BOARD_CARDS_COLUMN { 7 };
+static constexpr std::size_t ACTION_OFFSETS_COLUMN { 9 };
+
+// an empty directory, for the files of the given test
+[[nodiscard]] static std::filesystem::path makeTestDir(std::string_view testName) {
+  const auto ret { std::filesystem::temp_directory_path() / "prmTests" / testName };
+  std::filesystem::remove_all(ret);
+  std::filesystem::create_directories(ret);
+  return ret;
+}
+
+[[nodiscard]] static std::string readFile(const std::filesystem::path& file) {
+  std::ifstream in { file, std::ios::binary };
+  return { std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>() };
+}
+
+static void writeFile(const std::filesystem::path& file, std::string_view content) {
+  std::ofstream out { file, std::ios::binary | std::ios::trunc };
+  out.write(content.data(), static_cast<std::streamsize>(content.size()));
+}
+
+template<typename T>
+[[nodiscard]] static T readValue(std::string_view bytes, std::size_t offset) {
+  BOOST_REQUIRE(offset + sizeof(T) <= bytes.size());
+  T ret;
+  std::memcpy(&ret, bytes.data() + offset, sizeof(T));
+  return ret;
+}
+
+template<typename T>
+static void writeValue(std::string& bytes, std::size_t offset, T value) {
+  BOOST_REQUIRE(offset + sizeof(T) <= bytes.size());
+  std::memcpy(bytes.data() + offset, &value, sizeof(T));
+}
+
+// the offset in the file of the given column
+[[nodiscard]] static std::size_t getColumnOffset(std::string_view bytes, std::size_t column) {
+  return static_cast<std::size_t>(readValue<std::uint64_t>(bytes, COLUMNS_OFFSET + column * 2 * sizeof(std::uint64_t)));
+}
+
+// a hand store of the history file, in the given test directory
+[[nodiscard]] static std::filesystem::path writeHandStore(std::string_view testName) {
+  const auto file { makeTestDir(testName) / "hands.prmh" };
+  handStore::write(*WinamaxGameHistory::parseGameHistory(HISTORY_FILE), file);
+  return file;
+}
+
+// writes the given hand store corrupted by corrupt(), and requires that opening it throws
+static void requireInvalid(std::string_view testName, auto corrupt) {
+  const auto file { writeHandStore(testName) };
+  auto bytes { readFile(file) };
+  corrupt(bytes);
+  writeFile(file, bytes);
+  BOOST_REQUIRE_THROW(HandStore { file }, std::runtime_error);
+}
+
+BOOST_AUTO_TEST_SUITE(HandStoreTest)
+
+BOOST_AUTO_TEST_CASE(HandStoreTest_openShouldGiveTheWrittenHands) {
+  const auto pSite { WinamaxGameHistory::parseGameHistory(HISTORY_FILE) };
+  BOOST_REQUIRE(1 == pSite->viewCashGames().size());
+  const auto& game { *pSite->viewCashGames().front() };
+  const auto file { makeTestDir("handStore") / "hands.prmh" };
+  handStore::write(*pSite, file);
+  const HandStore store { file };
+  BOOST_REQUIRE(NB_HANDS == store.getNbHands());
+  std::size_t nbActions { 0 };
+
+  for (std::size_t i { 0 }; const auto* pHand : game.viewHands()) {
+    BOOST_REQUIRE(pHand->getId() == store.getHandIds()[i]);
+    BOOST_REQUIRE(pHand->getStartDate().toSysSeconds().time_since_epoch().count() == store.getStartDates()[i]);
+    BOOST_REQUIRE(pHand->getTableName() == store.toString(store.getTableNames()[i]));
+    BOOST_REQUIRE(game.getSmallBlind() == store.getStakes()[i].smallBlind);
+    BOOST_REQUIRE(game.getBigBlind() == store.getStakes()[i].bigBlind);
+    BOOST_REQUIRE(pHand->getGameType() == store.getStakes()[i].gameType);
+    BOOST_REQUIRE(pHand->getButtonSeat() == store.getButtonSeats()[i]);
+    BOOST_REQUIRE(std::ranges::equal(pHand->getSeats(), store.getSeats()[i], {}, [](PlayerId id) { return stringPool::view(id); },
+                                     [&store](StoredString s) { return store.toString(s); }));
+    BOOST_REQUIRE(pHand->getWinnerSeats() == store.getWinners()[i]);
+    BOOST_REQUIRE(pHand->getHeroCard1() == store.getHeroCards()[i][0]);
+    BOOST_REQUIRE(pHand->getBoardCard5() == store.getBoardCards()[i][4]);
+    BOOST_REQUIRE(std::ranges::equal(pHand->viewActions(), store.getActions(i), {},
+    [](const Action & a) { return std::tuple { a.getPlayerName(), a.getStreet(), a.getType(), a.getIndex(), a.getBetAmount() }; },
+    [&store](const StoredAction & a) {
+      return std::tuple { store.toString(a.playerName), a.street, a.type, std::size_t { a.index }, a.betAmount };
+    }));
+    nbActions += pHand->viewActions().size();
+    ++i;
+  }
+
+  BOOST_REQUIRE(nbActions == store.getActions().size());
+}
+
+BOOST_AUTO_TEST_CASE(HandStoreTest_writeShouldGiveTheSameBytesForTheSameHands) {
+  const auto pSite { WinamaxGameHistory::parseGameHistory(HISTORY_FILE) };
+  const auto dir { makeTestDir("handStoreBytes") };
+  handStore::write(*pSite, dir / "first.prmh");
+  handStore::write(*pSite, dir / "second.prmh");
+  BOOST_REQUIRE(readFile(dir / "first.prmh") == readFile(dir / "second.prmh"));
+}
+
+BOOST_AUTO_TEST_CASE(HandStoreTest_openShouldThrowOnATruncatedFile) {
+  requireInvalid("handStoreTruncated", [](std::string & bytes) { bytes.resize(bytes.size() / 2); });
+  requireInvalid("handStoreHeaderOnly", [](std::string & bytes) { bytes.resize(COLUMNS_OFFSET); });
+}
+
+BOOST_AUTO_TEST_CASE(HandStoreTest_openShouldThrowOnAnInvalidNumberOfHands) {
+  requireInvalid("handStoreNbHands", [](std::string & bytes) {
+    writeValue<std::uint64_t>(bytes, NB_HANDS_OFFSET, std::numeric_limits<std::uint64_t>::max());
+  });
+  requireInvalid("handStoreOneMoreHand", [](std::string & bytes) {
+    writeValue<std::uint64_t>(bytes, NB_HANDS_OFFSET, NB_HANDS + 1);
+  });
+}
+
+BOOST_AUTO_TEST_CASE(HandStoreTest_openShouldThrowOnAColumnOutOfTheFile) {
+  requireInvalid("handStoreColumn", [](std::string & bytes) {
+    writeValue<std::uint64_t>(bytes, COLUMNS_OFFSET + TABLE_NAMES_COLUMN * 2 * sizeof(std::uint64_t), bytes.size());
+  });
+}
+
+BOOST_AUTO_TEST_CASE(HandStoreTest_openShouldThrowOnAStringOutOfTheStrings) {
+  requireInvalid("handStoreString", [](std::string & bytes) {
+    const auto offset { getColumnOffset(bytes, TABLE_NAMES_COLUMN) };
+    writeValue<std::uint32_t>(bytes, offset, std::numeric_limits<std::uint32_t>::max());
+  });
+}
+
+BOOST_AUTO_TEST_CASE(HandStoreTest_openShouldThrowOnInvalidActionOffsets) {
+  requireInvalid("handStoreActionOffsets", [](std::string & bytes) {
+    const auto offset { getColumnOffset(bytes, ACTION_OFFSETS_COLUMN) };
+    writeValue<std::uint64_t>(bytes, offset + sizeof(std::uint64_t), std::numeric_limits<std::uint64_t>::max());
+  });
+}
+
+BOOST_AUTO_TEST_CASE(HandStoreTest_openShouldThrowOnAnInvalidCard) {
+  requireInvalid("handStoreCard", [](std::string & bytes) {
+    writeValue<std::int16_t>(bytes, getColumnOffset(bytes, BOARD_CARDS_COLUMN), 1000);
+  });
+}
+
+BOOST_AUTO_TEST_SUITE_END()
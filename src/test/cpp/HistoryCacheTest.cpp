@@ -0,0 +1,165 @@
+module;
+
+#include <boost/test/unit_test.hpp>
+
+export module test.history.HistoryCache;
+
+import entities.Action;
+import entities.Game;
+import entities.Hand;
+import entities.HandId;
+import entities.Site;
+import system.StringPool;
+import history.HistoryCache;
+import history.WinamaxGameHistory;
+
+import std;
+
+static const std::filesystem::path HISTORY_FILE { TEST_RESOURCES_DIR "20190206_Colorado_real_holdem_no-limit.txt" };
+static constexpr std::size_t NB_HANDS { 91 };
+
+// an empty directory, for the files of the given test
+[[nodiscard]] static std::filesystem::path makeTestDir(std::string_view testName) {
+  const auto ret { std::filesystem::temp_directory_path() / "prmTests" / testName };
+  std::filesystem::remove_all(ret);
+  std::filesystem::create_directories(ret);
+  return ret;
+}
+
+[[nodiscard]] static std::string readFile(const std::filesystem::path& file) {
+  std::ifstream in { file, std::ios::binary };
+  return { std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>() };
+}
+
+static void writeFile(const std::filesystem::path& file, std::string_view content) {
+  std::ofstream out { file, std::ios::binary | std::ios::trunc };
+  out.write(content.data(), static_cast<std::streamsize>(content.size()));
+}
+
+// the position of the bytes of the given hand id in a cache file content
+[[nodiscard]] static std::size_t findHandId(std::string_view bytes, HandId id) {
+  const auto ret { bytes.find(std::string_view(reinterpret_cast<const char*>(&id), sizeof(id))) };
+  BOOST_REQUIRE(std::string_view::npos != ret);
+  return ret;
+}
+
+// the only cache file written in cacheDir
+[[nodiscard]] static std::filesystem::path getCacheFile(const std::filesystem::path& cacheDir) {
+  const std::vector<std::filesystem::path> files { std::filesystem::directory_iterator(cacheDir), {} };
+  BOOST_REQUIRE(1 == files.size());
+  return files.front();
+}
+
+static void requireSameHand(const Hand& expected, const Hand& actual) {
+  BOOST_REQUIRE(expected.getId() == actual.getId());
+  BOOST_REQUIRE(expected.getGameType() == actual.getGameType());
+  BOOST_REQUIRE(expected.getTableName() == actual.getTableName());
+  BOOST_REQUIRE(expected.getButtonSeat() == actual.getButtonSeat());
+  BOOST_REQUIRE(expected.getMaxSeats() == actual.getMaxSeats());
+  BOOST_REQUIRE(expected.getStartDate() == actual.getStartDate());
+  BOOST_REQUIRE(expected.getSeats() == actual.getSeats());
+  BOOST_REQUIRE(expected.getWinnerSeats() == actual.getWinnerSeats());
+  BOOST_REQUIRE(expected.getBoardCard5() == actual.getBoardCard5());
+  BOOST_REQUIRE(std::ranges::equal(expected.viewActions(), actual.viewActions(), {},
+                                   [](const Action & a) { return std::tuple { a.getPlayerId(), a.getStreet(), a.getType(), a.getIndex(), a.getBetAmount() }; },
+                                   [](const Action & a) { return std::tuple { a.getPlayerId(), a.getStreet(), a.getType(), a.getIndex(), a.getBetAmount() }; }));
+}
+
+BOOST_AUTO_TEST_SUITE(HistoryCacheTest)
+
+BOOST_AUTO_TEST_CASE(HistoryCacheTest_loadShouldGiveTheStoredSite) {
+  const HistoryCache cache { makeTestDir("historyCache") };
+  const auto pParsed { WinamaxGameHistory::parseGameHistory(HISTORY_FILE) };
+  BOOST_REQUIRE(nullptr == cache.load(HISTORY_FILE));
+  cache.store(HISTORY_FILE, *pParsed);
+  const auto pLoaded { cache.load(HISTORY_FILE) };
+  BOOST_REQUIRE(nullptr != pLoaded);
+  BOOST_REQUIRE(pParsed->getName() == pLoaded->getName());
+  BOOST_REQUIRE(pParsed->viewPlayers().size() == pLoaded->viewPlayers().size());
+  BOOST_REQUIRE(pLoaded->viewTournaments().empty());
+  BOOST_REQUIRE(1 == pLoaded->viewCashGames().size());
+  const auto& expected { *pParsed->viewCashGames().front() };
+  const auto& actual { *pLoaded->viewCashGames().front() };
+  BOOST_REQUIRE(expected.getId() == actual.getId());
+  BOOST_REQUIRE(expected.getVariant() == actual.getVariant());
+  BOOST_REQUIRE(expected.getLimitType() == actual.getLimitType());
+  BOOST_REQUIRE(expected.getBigBlind() == actual.getBigBlind());
+  BOOST_REQUIRE(NB_HANDS == actual.viewHands().size());
+
+  for (std::size_t i { 0 }; i < NB_HANDS; ++i) { requireSameHand(*expected.viewHands()[i], *actual.viewHands()[i]); }
+}
+
+BOOST_AUTO_TEST_CASE(HistoryCacheTest_loadShouldMissOnAnInvalidValue) {
+  const auto cacheDir { makeTestDir("historyCacheInvalidValue") };
+  const HistoryCache cache { cacheDir };
+  cache.store(HISTORY_FILE, *WinamaxGameHistory::parseGameHistory(HISTORY_FILE));
+  const auto cacheFile { getCacheFile(cacheDir) };
+  auto bytes { readFile(cacheFile) };
+  // the game type of the first hand follows its id
+  bytes[findHandId(bytes, HandId { 12266668, 4174329, 1549487680 }) + sizeof(HandId)] = 7;
+  writeFile(cacheFile, bytes);
+  BOOST_REQUIRE(nullptr == cache.load(HISTORY_FILE));
+}
+
+BOOST_AUTO_TEST_CASE(HistoryCacheTest_loadShouldMissOnAWinnerWithoutSeat) {
+  const auto cacheDir { makeTestDir("historyCacheWinnerWithoutSeat") };
+  const HistoryCache cache { cacheDir };
+  const auto pParsed { WinamaxGameHistory::parseGameHistory(HISTORY_FILE) };
+  cache.store(HISTORY_FILE, *pParsed);
+  const auto cacheFile { getCacheFile(cacheDir) };
+  auto bytes { readFile(cacheFile) };
+  const auto hands { pParsed->viewCashGames().front()->viewHands() };
+  const auto& seats { hands[0]->getSeats() };
+  const auto emptySeat { std::ranges::find(seats, PlayerId::none) };
+  BOOST_REQUIRE(seats.end() != emptySeat);
+  // the winners of the first hand are the 2 bytes before the id of the second hand
+  const auto winnersPos { findHandId(bytes, hands[1]->getId()) - sizeof(std::uint16_t) };
+  std::uint16_t winners;
+  std::memcpy(&winners, bytes.data() + winnersPos, sizeof(winners));
+  BOOST_REQUIRE(hands[0]->getWinnerSeats() == winners);
+  winners |= static_cast<std::uint16_t>(1U << (emptySeat - seats.begin()));
+  std::memcpy(bytes.data() + winnersPos, &winners, sizeof(winners));
+  writeFile(cacheFile, bytes);
+  BOOST_REQUIRE(nullptr == cache.load(HISTORY_FILE));
+}
+
+BOOST_AUTO_TEST_CASE(HistoryCacheTest_loadShouldMissWhenTheMiddleOfTheFileChanged) {
+  const auto dir { makeTestDir("historyCacheMiddleChanged") };
+  const auto file { dir / HISTORY_FILE.filename() };
+  // the history 3 times, with other hand ids, so that its middle is far from its first and last 64 KiB
+  const auto history { readFile(HISTORY_FILE) };
+  auto content { history };
+
+  for (const auto tableId : { "22222222", "33333333" }) {
+    auto copy { history };
+
+    for (auto pos { copy.find("#12266668-") }; std::string::npos != pos; pos = copy.find("#12266668-", pos)) {
+      copy.replace(pos + 1, 8, tableId);
+    }
+
+    content += copy;
+  }
+
+  writeFile(file, content);
+  BOOST_REQUIRE(3 * 64 * 1024 < content.size());
+  const HistoryCache cache { dir / "cache" };
+  cache.store(file, *WinamaxGameHistory::parseGameHistory(file));
+  BOOST_REQUIRE(nullptr != cache.load(file));
+  const auto lastWriteTime { std::filesystem::last_write_time(file) };
+  // an amount in the middle of the file
+  const auto pos { content.find("€", content.size() / 2) - 1 };
+  BOOST_REQUIRE(std::isdigit(static_cast<unsigned char>(content[pos])));
+  content[pos] = '9' == content[pos] ? '8' : '9';
+  writeFile(file, content);
+  std::filesystem::last_write_time(file, lastWriteTime);
+  BOOST_REQUIRE(content.size() == std::filesystem::file_size(file));
+  BOOST_REQUIRE(nullptr == cache.load(file));
+}
+
+BOOST_AUTO_TEST_CASE(HistoryCacheTest_anEmptyDirShouldDisableTheCache) {
+  const HistoryCache cache { std::filesystem::path() };
+  cache.store(HISTORY_FILE, *WinamaxGameHistory::parseGameHistory(HISTORY_FILE));
+  BOOST_REQUIRE(nullptr == cache.load(HISTORY_FILE));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,73 @@
+module;
+
+#include <boost/test/unit_test.hpp>
+
+export module test.system.LineScanner;
+
+import system.LineScanner;
+
+import std;
+
+static constexpr std::array SCANNERS { LineScanner::scalar, LineScanner::sse2, LineScanner::avx2 };
+
+// the scanners of SCANNERS give the same positions as the scalar one, from every start position
+static void requireSameAsScalar(std::string_view text) {
+  for (const auto scanner : SCANNERS) {
+    if (!lineScanner::isSupported(scanner)) { continue; }
+
+    for (std::size_t from { 0 }; from <= text.size() + 1; ++from) {
+      BOOST_REQUIRE_MESSAGE(lineScanner::findNewline(LineScanner::scalar, text, from)
+                            == lineScanner::findNewline(scanner, text, from),
+                            lineScanner::toString(scanner) << " differs for a text of size " << text.size()
+                            << " from " << from);
+    }
+  }
+}
+
+BOOST_AUTO_TEST_SUITE(LineScannerTest)
+
+BOOST_AUTO_TEST_CASE(LineScannerTest_scalarShouldFindTheFirstNewline) {
+  BOOST_REQUIRE(std::string_view::npos == lineScanner::findNewline(LineScanner::scalar, "", 0));
+  BOOST_REQUIRE(std::string_view::npos == lineScanner::findNewline(LineScanner::scalar, "abc", 0));
+  BOOST_REQUIRE(3 == lineScanner::findNewline(LineScanner::scalar, "abc\ndef\n", 0));
+  BOOST_REQUIRE(7 == lineScanner::findNewline(LineScanner::scalar, "abc\ndef\n", 4));
+  BOOST_REQUIRE(4 == lineScanner::findNewline(LineScanner::scalar, "abc\r\n", 0));
+}
+
+BOOST_AUTO_TEST_CASE(LineScannerTest_simdShouldFindTheNewlinesAroundTheChunkBorders) {
+  // lengths around the 16 and 32 bytes chunks, with a "\r\n" or a '\n' at each position
+  for (std::size_t size { 0 }; size <= 70; ++size) {
+    const std::string noNewline(size, 'a');
+    requireSameAsScalar(noNewline);
+
+    for (std::size_t pos { 0 }; pos < size; ++pos) {
+      auto text { noNewline };
+      text[pos] = '\n';
+      requireSameAsScalar(text);
+
+      if (0 < pos) {
+        text[pos - 1] = '\r';
+        requireSameAsScalar(text);
+      }
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(LineScannerTest_simdShouldFindTheSameNewlinesAsScalarInRandomTexts) {
+  std::mt19937 random { 42 }; // a fixed seed, so that a failure can be replayed
+  std::uniform_int_distribution<std::size_t> sizes { 0, 200 };
+  std::uniform_int_distribution<std::size_t> chars { 0, 7 };
+
+  for (int i { 0 }; i < 500; ++i) {
+    std::string text(sizes(random), ' ');
+    std::ranges::generate(text, [&] { return "ab \t\r\n\xe2\x82"[chars(random)]; });
+    requireSameAsScalar(text);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(LineScannerTest_bestShouldBeSupported) {
+  BOOST_REQUIRE(lineScanner::isSupported(lineScanner::best()));
+  BOOST_REQUIRE(lineScanner::findNewline(lineScanner::best(), "a\r\nb", 0) == lineScanner::findNewline("a\r\nb", 0));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
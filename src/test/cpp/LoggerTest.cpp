@@ -0,0 +1,160 @@
+module;
+
+#include <boost/test/unit_test.hpp>
+
+export module test.system.Logger;
+
+import system.Logger;
+
+import std;
+
+// captures what the logger writes on the standard and error outputs, while it exists
+class [[nodiscard]] LogCapture final {
+private:
+  std::ostringstream m_out {};
+  std::ostringstream m_err {};
+  std::streambuf* m_pCoutBuffer;
+  std::streambuf* m_pCerrBuffer;
+
+public:
+  // the messages queued before are written first, not captured
+  LogCapture()
+    : m_pCoutBuffer { (logger::flush(), std::cout.rdbuf(m_out.rdbuf())) },
+      m_pCerrBuffer { std::cerr.rdbuf(m_err.rdbuf()) } {}
+  LogCapture(const LogCapture&) = delete;
+  LogCapture(LogCapture&&) = delete;
+  LogCapture& operator=(const LogCapture&) = delete;
+  LogCapture& operator=(LogCapture&&) = delete;
+
+  ~LogCapture() {
+    logger::flush();
+    std::cout.rdbuf(m_pCoutBuffer);
+    std::cerr.rdbuf(m_pCerrBuffer);
+  }
+
+  [[nodiscard]] std::string getOut() {
+    logger::flush();
+    return m_out.str();
+  }
+
+  [[nodiscard]] std::string getErr() {
+    logger::flush();
+    return m_err.str();
+  }
+}; // class LogCapture
+
+// restores the default settings when destroyed
+struct [[nodiscard]] LoggerSettings final {
+  LoggerSettings() = default;
+  LoggerSettings(const LoggerSettings&) = delete;
+  LoggerSettings(LoggerSettings&&) = delete;
+  LoggerSettings& operator=(const LoggerSettings&) = delete;
+  LoggerSettings& operator=(LoggerSettings&&) = delete;
+
+  ~LoggerSettings() {
+    logger::setLevel(logger::COMPILED_LEVEL);
+    logger::setCategoryEnabled(LogCategory::parser, true);
+    logger::setCategoryEnabled(LogCategory::import, true);
+    logger::setCategoryEnabled(LogCategory::file, true);
+  }
+};
+
+[[nodiscard]] static std::size_t countLines(std::string_view text, std::string_view line) {
+  std::size_t ret { 0 };
+
+  for (auto pos { text.find(line) }; std::string_view::npos != pos; pos = text.find(line, pos + line.size())) { ++ret; }
+
+  return ret;
+}
+
+BOOST_AUTO_TEST_SUITE(LoggerTest)
+
+BOOST_AUTO_TEST_CASE(LoggerTest_shouldFilterByLevel) {
+  const LoggerSettings settings;
+  logger::setLevel(LogLevel::warning);
+  BOOST_REQUIRE(!logger::isEnabled(LogLevel::info, LogCategory::parser));
+  BOOST_REQUIRE(logger::isEnabled(LogLevel::warning, LogCategory::parser));
+  BOOST_REQUIRE(logger::isEnabled(LogLevel::error, LogCategory::parser));
+  // the levels removed at compile time can't be enabled
+  logger::setLevel(LogLevel::trace);
+  BOOST_REQUIRE((logger::COMPILED_LEVEL <= LogLevel::trace) == logger::isEnabled(LogLevel::trace, LogCategory::parser));
+  LogCapture capture;
+  logger::setLevel(LogLevel::error);
+  logger::warning(LogCategory::parser, "hidden warning {}", 1);
+  logger::error(LogCategory::parser, "shown error {}", 2);
+  const auto err { capture.getErr() };
+  BOOST_REQUIRE(std::string::npos == err.find("hidden warning"));
+  BOOST_REQUIRE(1 == countLines(err, "[error][parser] shown error 2\n"));
+}
+
+BOOST_AUTO_TEST_CASE(LoggerTest_shouldFilterByCategory) {
+  const LoggerSettings settings;
+  logger::setCategoryEnabled(LogCategory::import, false);
+  BOOST_REQUIRE(!logger::isEnabled(LogLevel::error, LogCategory::import));
+  BOOST_REQUIRE(logger::isEnabled(LogLevel::error, LogCategory::file));
+  LogCapture capture;
+  logger::error(LogCategory::import, "hidden import");
+  logger::error(LogCategory::file, "shown file");
+  logger::setCategoryEnabled(LogCategory::import, true);
+  logger::error(LogCategory::import, "shown import");
+  const auto err { capture.getErr() };
+  BOOST_REQUIRE(std::string::npos == err.find("hidden import"));
+  BOOST_REQUIRE(1 == countLines(err, "[error][file] shown file\n"));
+  BOOST_REQUIRE(1 == countLines(err, "[error][import] shown import\n"));
+}
+
+BOOST_AUTO_TEST_CASE(LoggerTest_shouldWriteWarningsOnTheErrorOutput) {
+  LogCapture capture;
+  logger::info(LogCategory::file, "an info");
+  logger::warning(LogCategory::file, "a warning");
+  const auto out { capture.getOut() };
+  const auto err { capture.getErr() };
+  BOOST_REQUIRE(1 == countLines(out, "[info][file] an info\n"));
+  BOOST_REQUIRE(std::string::npos == out.find("a warning"));
+  BOOST_REQUIRE(1 == countLines(err, "[warning][file] a warning\n"));
+  BOOST_REQUIRE(std::string::npos == err.find("an info"));
+}
+
+BOOST_AUTO_TEST_CASE(LoggerTest_shouldTruncateTheLongMessages) {
+  const std::string longText(logger::MAX_MESSAGE_SIZE + 50, 'x');
+  const std::string truncatedText(logger::MAX_MESSAGE_SIZE, 'x');
+  LogCapture capture;
+  // truncated when formatted
+  logger::error(LogCategory::parser, "{}", longText);
+  // truncated when queued
+  logger::write(LogLevel::error, LogCategory::parser, longText);
+  BOOST_REQUIRE(2 == countLines(capture.getErr(), std::format("[error][parser] {}\n", truncatedText)));
+}
+
+BOOST_AUTO_TEST_CASE(LoggerTest_shouldCountTheDroppedMessages) {
+  constexpr std::size_t NB_MESSAGES { 100'000 };
+  LogCapture capture;
+
+  // faster than the flusher, so that the buffer of the thread gets full
+  for (std::size_t i { 0 }; i < NB_MESSAGES; ++i) { logger::error(LogCategory::parser, "message {}", i); }
+
+  const auto err { capture.getErr() };
+  const auto nbWritten { countLines(err, "[error][parser] message ") };
+  constexpr std::string_view DROPPED_PREFIX { "[warning][log] " };
+  std::size_t nbDropped { 0 };
+  std::istringstream lines { err };
+
+  for (std::string line; std::getline(lines, line);) {
+    if (line.starts_with(DROPPED_PREFIX)) { nbDropped += std::stoul(line.substr(DROPPED_PREFIX.size())); }
+  }
+
+  BOOST_REQUIRE(0 < nbDropped);
+  BOOST_REQUIRE(NB_MESSAGES == nbWritten + nbDropped);
+}
+
+BOOST_AUTO_TEST_CASE(LoggerTest_shouldWriteTheMessagesOfAThreadGoneBeforeTheFlush) {
+  LogCapture capture;
+  std::jthread { []() {
+    logger::info(LogCategory::import, "from a thread");
+    logger::warning(LogCategory::import, "from a thread");
+  } }.join();
+  BOOST_REQUIRE(1 == countLines(capture.getOut(), "[info][import] from a thread\n"));
+  BOOST_REQUIRE(1 == countLines(capture.getErr(), "[warning][import] from a thread\n"));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
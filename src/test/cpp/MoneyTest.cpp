@@ -0,0 +1,22 @@
+module;
+
+#include <boost/test/unit_test.hpp>
+
+export module test.system.Money;
+
+import system.Money;
+
+BOOST_AUTO_TEST_SUITE(MoneyTest)
+
+BOOST_AUTO_TEST_CASE(MoneyTest_parseShouldBeExact) {
+  BOOST_REQUIRE(money::parse("1,28€").toCents() == 128);
+  BOOST_REQUIRE(money::parse("0.1€") + money::parse("0.2€") == money::parse("0.3€"));
+}
+
+BOOST_AUTO_TEST_CASE(MoneyTest_parseBuyInShouldSumTheAmounts) {
+  BOOST_REQUIRE(money::parseBuyIn("0.45€ + 0.05€").toCents() == 50);
+  BOOST_REQUIRE(money::parseBuyIn("9,20€ + 0,80€").toCents() == 1000);
+  BOOST_REQUIRE(money::parseBuyIn("Free").toCents() == 0);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
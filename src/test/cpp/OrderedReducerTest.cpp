@@ -0,0 +1,113 @@
+module;
+
+#include <boost/test/unit_test.hpp>
+
+export module test.system.OrderedReducer;
+
+import system.OrderedReducer;
+
+import std;
+
+// a merge that is associative but not commutative, so that the result tells the merge order
+static constexpr auto CONCATENATE { [](std::string& left, std::string&& right) { left += right; } };
+
+using StringReducer = OrderedReducer<std::string, decltype(CONCATENATE)>;
+
+[[nodiscard]] static std::string toValue(std::size_t index) { return std::format("{},", index); }
+
+[[nodiscard]] static std::string getExpected(std::size_t nbValues) {
+  std::string ret;
+
+  for (std::size_t i { 0 }; i < nbValues; ++i) { ret += toValue(i); }
+
+  return ret;
+}
+
+BOOST_AUTO_TEST_SUITE(OrderedReducerTest)
+
+BOOST_AUTO_TEST_CASE(OrderedReducerTest_takeShouldGiveTheMergeInIndexOrderWhateverTheSetOrder) {
+  std::array<std::size_t, 6> indexes { 0, 1, 2, 3, 4, 5 };
+
+  do {
+    StringReducer reducer { indexes.size(), CONCATENATE };
+    std::ranges::for_each(indexes, [&reducer](std::size_t i) { reducer.set(i, toValue(i)); });
+    BOOST_REQUIRE(getExpected(indexes.size()) == reducer.take());
+  } while (std::ranges::next_permutation(indexes).found);
+}
+
+BOOST_AUTO_TEST_CASE(OrderedReducerTest_concurrentSetsShouldGiveTheMergeInIndexOrder) {
+  constexpr std::size_t NB_VALUES { 10'000 };
+  constexpr std::size_t NB_THREADS { 8 };
+
+  for (unsigned seed { 0 }; seed < 10; ++seed) {
+    std::vector<std::size_t> indexes(NB_VALUES);
+    std::iota(indexes.begin(), indexes.end(), std::size_t { 0 });
+    std::ranges::shuffle(indexes, std::mt19937 { seed });
+    StringReducer reducer { NB_VALUES, CONCATENATE };
+    {
+      std::vector<std::jthread> threads;
+
+      for (std::size_t t { 0 }; t < NB_THREADS; ++t) {
+        threads.emplace_back([&reducer, &indexes, t]() {
+          for (auto i { t }; i < indexes.size(); i += NB_THREADS) { reducer.set(indexes[i], toValue(indexes[i])); }
+        });
+      }
+    }
+    BOOST_REQUIRE(getExpected(NB_VALUES) == reducer.take());
+  }
+}
+
+BOOST_AUTO_TEST_CASE(OrderedReducerTest_claimShouldBoundTheValuesNotMergedIntoTheFirstOne) {
+  constexpr std::size_t NB_VALUES { 300 };
+  constexpr std::size_t NB_THREADS { 8 };
+
+  for (const auto maxNbPending : { 1UZ, 3UZ, 8UZ, 20UZ }) {
+    std::atomic_size_t nbPending { 0 }; // the values claimed, not yet merged into the value of index 0
+    std::atomic_size_t maxNbPendingSeen { 0 };
+    // the values are the indexes they hold
+    const auto merge { [&nbPending](std::vector<std::size_t>& left, std::vector<std::size_t>&& right) {
+      if (0 == left.front()) { nbPending -= right.size(); }
+
+      left.insert(left.end(), right.begin(), right.end());
+    } };
+    // the last values first, the ones that wait the longest to be merged into the first value
+    std::vector<std::size_t> claimOrder(NB_VALUES);
+    std::iota(claimOrder.rbegin(), claimOrder.rend(), std::size_t { 0 });
+    OrderedReducer<std::vector<std::size_t>, decltype(merge)> reducer { claimOrder, merge, maxNbPending };
+    {
+      std::vector<std::jthread> threads;
+
+      for (std::size_t t { 0 }; t < NB_THREADS; ++t) {
+        threads.emplace_back([&, t]() {
+          std::mt19937 random { static_cast<unsigned>(t) };
+
+          for (auto i { t }; i < NB_VALUES; i += NB_THREADS) {
+            const auto index { reducer.claim() };
+            const auto nb { ++nbPending };
+            auto seen { maxNbPendingSeen.load() };
+
+            while (seen < nb and !maxNbPendingSeen.compare_exchange_weak(seen, nb)) {}
+
+            std::this_thread::sleep_for(std::chrono::microseconds { random() % 100 });
+
+            if (0 == index) { --nbPending; }
+
+            reducer.set(index, { index });
+          }
+        });
+      }
+    }
+    BOOST_REQUIRE_MESSAGE(maxNbPendingSeen <= maxNbPending, maxNbPendingSeen << " values pending for " << maxNbPending);
+    std::vector<std::size_t> expected(NB_VALUES);
+    std::iota(expected.begin(), expected.end(), std::size_t { 0 });
+    BOOST_REQUIRE(expected == reducer.take());
+    BOOST_REQUIRE(0 == nbPending);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(OrderedReducerTest_takeShouldGiveAnEmptyValueWithoutValues) {
+  StringReducer reducer { 0, CONCATENATE };
+  BOOST_REQUIRE(reducer.take().empty());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,95 @@
+module;
+
+#include <boost/test/unit_test.hpp>
+
+export module test.system.StringPool;
+
+import system.StringPool;
+
+import std;
+
+// strings that no other test interns, as the pool is shared by the whole process
+[[nodiscard]] static std::vector<std::string> makeStrings(std::string_view testName, std::size_t nbStrings) {
+  std::vector<std::string> ret;
+  ret.reserve(nbStrings);
+
+  for (std::size_t i { 0 }; i < nbStrings; ++i) { ret.push_back(std::format("StringPoolTest_{}_{}", testName, i)); }
+
+  return ret;
+}
+
+BOOST_AUTO_TEST_SUITE(StringPoolTest)
+
+BOOST_AUTO_TEST_CASE(StringPoolTest_internShouldGiveTheSameIdForTheSameString) {
+  const auto id { stringPool::intern("StringPoolTest_same") };
+  BOOST_REQUIRE(StringId::empty != id);
+  BOOST_REQUIRE(id == stringPool::intern(std::string("StringPoolTest_") + "same"));
+  BOOST_REQUIRE(id != stringPool::intern("StringPoolTest_other"));
+  BOOST_REQUIRE("StringPoolTest_same" == stringPool::view(id));
+  BOOST_REQUIRE(std::to_underlying(id) == std::to_underlying(stringPool::internPlayer("StringPoolTest_same")));
+}
+
+BOOST_AUTO_TEST_CASE(StringPoolTest_theEmptyStringShouldBeTheEmptyId) {
+  BOOST_REQUIRE(StringId::empty == stringPool::intern(""));
+  BOOST_REQUIRE(PlayerId::none == stringPool::internPlayer(""));
+  BOOST_REQUIRE(stringPool::view(StringId::empty).empty());
+  BOOST_REQUIRE(stringPool::view(PlayerId::none).empty());
+  BOOST_REQUIRE(StringId::empty == stringPool::find(""));
+}
+
+BOOST_AUTO_TEST_CASE(StringPoolTest_findShouldNotIntern) {
+  const auto nbStrings { stringPool::getNbStrings() };
+  BOOST_REQUIRE(!stringPool::find("StringPoolTest_find").has_value());
+  BOOST_REQUIRE(!stringPool::findPlayer("StringPoolTest_find").has_value());
+  BOOST_REQUIRE(nbStrings == stringPool::getNbStrings());
+  const auto id { stringPool::intern("StringPoolTest_find") };
+  BOOST_REQUIRE(id == stringPool::find("StringPoolTest_find"));
+  BOOST_REQUIRE(std::to_underlying(id) == std::to_underlying(stringPool::findPlayer("StringPoolTest_find").value()));
+  BOOST_REQUIRE(nbStrings + 1 == stringPool::getNbStrings());
+}
+
+BOOST_AUTO_TEST_CASE(StringPoolTest_viewsShouldStayValidWhileThePoolGrows) {
+  const std::string longString(100 * 1024, 'x'); // bigger than a block
+  const auto longId { stringPool::intern(longString) };
+  const auto shortId { stringPool::intern("StringPoolTest_grows") };
+  const auto shortView { stringPool::view(shortId) };
+  const auto strings { makeStrings("grows", 20'000) }; // several chunks of ids and blocks of characters
+  std::ranges::for_each(strings, [](const auto & s) { std::ignore = stringPool::intern(s); });
+  BOOST_REQUIRE(shortView.data() == stringPool::view(shortId).data());
+  BOOST_REQUIRE("StringPoolTest_grows" == shortView);
+  BOOST_REQUIRE(longString == stringPool::view(longId));
+  BOOST_REQUIRE(std::ranges::all_of(strings, [](const auto & s) { return s == stringPool::view(stringPool::intern(s)); }));
+}
+
+BOOST_AUTO_TEST_CASE(StringPoolTest_concurrentInternsShouldGiveOneIdPerString) {
+  const auto strings { makeStrings("concurrent", 5'000) };
+  const auto nbStringsBefore { stringPool::getNbStrings() };
+  // each thread in another order, so that threads intern the same strings at the same time: the
+  // strides are prime with the number of strings, so each thread interns all of them
+  constexpr std::array STRIDES { 1UZ, 3UZ, 7UZ, 9UZ, 11UZ, 13UZ, 17UZ, 19UZ };
+  std::array<std::vector<StringId>, STRIDES.size()> ids;
+  {
+    std::vector<std::jthread> threads;
+
+    for (std::size_t t { 0 }; t < STRIDES.size(); ++t) {
+      threads.emplace_back([&strings, &threadIds = ids[t], stride = STRIDES[t]]() {
+        threadIds.resize(strings.size());
+
+        for (std::size_t i { 0 }; i < strings.size(); ++i) {
+          const auto index { i * stride % strings.size() };
+          threadIds[index] = stringPool::intern(strings[index]);
+        }
+      });
+    }
+  }
+  BOOST_REQUIRE(nbStringsBefore + strings.size() == stringPool::getNbStrings());
+  BOOST_REQUIRE(std::ranges::all_of(ids, [&ids](const auto & threadIds) { return threadIds == ids.front(); }));
+
+  for (std::size_t i { 0 }; i < strings.size(); ++i) { BOOST_REQUIRE(strings[i] == stringPool::view(ids.front()[i])); }
+
+  auto sortedIds { ids.front() };
+  std::ranges::sort(sortedIds);
+  BOOST_REQUIRE(sortedIds.end() == std::ranges::adjacent_find(sortedIds));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
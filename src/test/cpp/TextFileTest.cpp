@@ -0,0 +1,45 @@
+module;
+
+#include <boost/test/unit_test.hpp>
+
+export module test.system.TextFile;
+
+import system.TextFile;
+
+import std;
+
+static const std::filesystem::path HISTORY_FILE { TEST_RESOURCES_DIR "20190206_Colorado_real_holdem_no-limit.txt" };
+
+[[nodiscard]] static std::vector<std::string> readLines(TextFile& tf) {
+  std::vector<std::string> ret;
+
+  while (tf.next()) { ret.emplace_back(tf.getLine()); }
+
+  return ret;
+}
+
+BOOST_AUTO_TEST_SUITE(TextFileTest)
+
+BOOST_AUTO_TEST_CASE(TextFileTest_streamedShouldReadTheSameLinesAsMemoryMapped) {
+  TextFile mapped { HISTORY_FILE };
+  TextFile streamed { HISTORY_FILE, TextFileMode::streamed, 100 }; // lines straddle chunks
+  const auto mappedLines { readLines(mapped) };
+  BOOST_REQUIRE(2747 == mappedLines.size());
+  BOOST_REQUIRE(mappedLines == readLines(streamed));
+}
+
+BOOST_AUTO_TEST_CASE(TextFileTest_streamedShouldKeepItsBufferSize) {
+  TextFile streamed { HISTORY_FILE, TextFileMode::streamed, 1024 };
+  std::ignore = readLines(streamed);
+  BOOST_REQUIRE(1024 == streamed.getPeakBufferSize());
+  BOOST_REQUIRE(1024 < std::filesystem::file_size(HISTORY_FILE));
+}
+
+BOOST_AUTO_TEST_CASE(TextFileTest_streamedShouldGrowOnlyForTooLongLines) {
+  TextFile streamed { HISTORY_FILE, TextFileMode::streamed, 16 };
+  std::ignore = readLines(streamed);
+  // the longest line of the file is less than 256 characters long
+  BOOST_REQUIRE(256 >= streamed.getPeakBufferSize());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
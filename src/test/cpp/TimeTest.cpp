@@ -0,0 +1,66 @@
+module;
+
+#include <boost/test/unit_test.hpp>
+
+export module test.system.Time;
+
+import system.Time;
+
+import std;
+
+static constexpr std::string_view WINAMAX_FORMAT { "%Y/%m/%d %H:%M:%S" };
+static constexpr std::string_view PMU_FORMAT { "%d/%m/%Y %H:%M:%S" }; // not a fixed format, parsed by std::get_time
+
+[[nodiscard]] static constexpr std::chrono::sys_seconds toSysSeconds(std::chrono::year_month_day date, int hour,
+    int minute, int second) {
+  return std::chrono::sys_days { date } + std::chrono::hours { hour } + std::chrono::minutes { minute }
+         + std::chrono::seconds { second };
+}
+
+BOOST_AUTO_TEST_SUITE(TimeTest)
+
+BOOST_AUTO_TEST_CASE(TimeTest_shouldParseWinamaxDates) {
+  using namespace std::chrono;
+  const auto oTime { Time::parse({ .strTime = "2019/02/06 21:14:40", .format = WINAMAX_FORMAT }) };
+  BOOST_REQUIRE(oTime.has_value());
+  BOOST_REQUIRE(toSysSeconds(2019y / February / 6d, 21, 14, 40) == oTime->toSysSeconds());
+  BOOST_REQUIRE(Time({ .strTime = "2020/02/29 00:00:00", .format = WINAMAX_FORMAT }).toSysSeconds()
+                == toSysSeconds(2020y / February / 29d, 0, 0, 0));
+  BOOST_REQUIRE(Time({ .strTime = "2014-10-31 23:59:59", .format = SQLITE_DATE_FORMAT }).toSysSeconds()
+                == toSysSeconds(2014y / October / 31d, 23, 59, 59));
+}
+
+BOOST_AUTO_TEST_CASE(TimeTest_shouldParsePmuDates) {
+  using namespace std::chrono;
+  const auto oTime { Time::parse({ .strTime = "06/02/2019 21:14:40", .format = PMU_FORMAT }) };
+  BOOST_REQUIRE(oTime.has_value());
+  BOOST_REQUIRE(toSysSeconds(2019y / February / 6d, 21, 14, 40) == oTime->toSysSeconds());
+  BOOST_REQUIRE(oTime == Time::parse({ .strTime = "2019/02/06 21:14:40", .format = WINAMAX_FORMAT }));
+}
+
+BOOST_AUTO_TEST_CASE(TimeTest_shouldRejectMalformedWinamaxDates) {
+  for (const auto strTime : { "", "2019/02/06", "2019/02/06 21:14:4", "2019/02/06 21:14:400", "2019-02-06 21:14:40",
+                              "2019/02/06T21:14:40", "2019/0a/06 21:14:40", "2019/02/06 21:14:-1",
+                              "2019/02/30 21:14:40", "2019/13/06 21:14:40", "2019/00/06 21:14:40",
+                              "2019/02/06 24:14:40", "2019/02/06 21:60:40" }) {
+    BOOST_REQUIRE_MESSAGE(!Time::parse({ .strTime = strTime, .format = WINAMAX_FORMAT }).has_value(), strTime);
+    BOOST_REQUIRE_THROW(Time({ .strTime = strTime, .format = WINAMAX_FORMAT }), std::string);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(TimeTest_shouldRejectASecondOf60) {
+  BOOST_REQUIRE(!Time::parse({ .strTime = "2019/02/06 21:14:60", .format = WINAMAX_FORMAT }).has_value());
+  BOOST_REQUIRE(!Time::parse({ .strTime = "2019/02/06 23:59:60", .format = WINAMAX_FORMAT }).has_value());
+  BOOST_REQUIRE_THROW(Time({ .strTime = "2019/02/06 21:14:60", .format = WINAMAX_FORMAT }), std::string);
+  BOOST_REQUIRE(!Time::parse({ .strTime = "06/02/2019 21:14:60", .format = PMU_FORMAT }).has_value());
+  BOOST_REQUIRE(Time::parse({ .strTime = "2019/02/06 21:14:59", .format = WINAMAX_FORMAT }).has_value());
+}
+
+BOOST_AUTO_TEST_CASE(TimeTest_shouldRejectMalformedPmuDates) {
+  for (const auto strTime : { "", "06/02/2019", "06/02/2019 21:14", "06/02/2019 21:14:40 ", "2019/02/06 21:14:40",
+                              "xx/02/2019 21:14:40", "30/02/2019 21:14:40", "06/13/2019 21:14:40" }) {
+    BOOST_REQUIRE_MESSAGE(!Time::parse({ .strTime = strTime, .format = PMU_FORMAT }).has_value(), strTime);
+  }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
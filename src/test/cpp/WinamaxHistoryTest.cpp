@@ -0,0 +1,407 @@
+module;
+
+#include <boost/test/unit_test.hpp>
+
+export module test.history.WinamaxHistory;
+
+import entities.Action;
+import entities.Card;
+import entities.Game;
+import entities.Hand;
+import entities.HandId;
+import entities.Site;
+import history.HandStore;
+import history.WinamaxHistory;
+
+import std;
+
+static const std::filesystem::path HISTORY_FILE { TEST_RESOURCES_DIR "20190206_Colorado_real_holdem_no-limit.txt" };
+static constexpr std::size_t NB_HANDS { 91 };
+
+[[nodiscard]] static std::string readFile(const std::filesystem::path& file) {
+  std::ifstream in { file, std::ios::binary };
+  return { std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>() };
+}
+
+static void writeFile(const std::filesystem::path& file, std::string_view content, std::ios::openmode mode = std::ios::trunc) {
+  std::ofstream out { file, std::ios::binary | mode };
+  out.write(content.data(), static_cast<std::streamsize>(content.size()));
+}
+
+// an empty directory, for the files of the given test
+[[nodiscard]] static std::filesystem::path makeTestDir(std::string_view testName) {
+  const auto ret { std::filesystem::temp_directory_path() / "prmTests" / testName };
+  std::filesystem::remove_all(ret);
+  std::filesystem::create_directories(ret);
+  return ret;
+}
+
+// a Winamax history directory, with the files that WinamaxHistory::isValidHistoryDir() expects
+[[nodiscard]] static std::filesystem::path makeHistoryDir(std::string_view testName) {
+  const auto ret { makeTestDir(testName) };
+  std::filesystem::create_directories(ret / "data");
+  std::filesystem::create_directories(ret / "history");
+  writeFile(ret / "history" / "winamax_positioning_file.dat", "");
+  writeFile(ret / "history" / "20190206_summary.txt", "");
+  return ret;
+}
+
+// the history file with its hand ids starting by tableId instead of 12266668
+[[nodiscard]] static std::string withTableId(std::string_view tableId) {
+  auto ret { readFile(HISTORY_FILE) };
+
+  for (auto pos { ret.find("#12266668-") }; std::string::npos != pos; pos = ret.find("#12266668-", pos)) {
+    ret.replace(pos + 1, 8, tableId);
+  }
+
+  return ret;
+}
+
+// the first hand of the history file, followed by its 2 empty lines, with another hand id
+[[nodiscard]] static std::string newHand() {
+  auto ret { readFile(HISTORY_FILE) };
+  ret.resize(ret.find("\n\n\n") + 3);
+  ret.replace(ret.find("#12266668-4174329-"), 18, "#12266668-9999999-");
+  return ret;
+}
+
+// the positions of the starts of the hands in a history file content
+[[nodiscard]] static std::vector<std::size_t> getHandStarts(std::string_view content) {
+  std::vector<std::size_t> ret;
+
+  for (auto pos { content.find("Winamax Poker - ") }; std::string_view::npos != pos;
+       pos = content.find("Winamax Poker - ", pos + 1)) {
+    ret.push_back(pos);
+  }
+
+  return ret;
+}
+
+[[nodiscard]] static const Hand* findHand(const Site& site, HandId id) {
+  for (const auto* pGame : site.viewCashGames()) {
+    const auto hands { pGame->viewHands() };
+
+    if (const auto it { std::ranges::find(hands, id, &Hand::getId) }; hands.end() != it) { return *it; }
+  }
+
+  return nullptr;
+}
+
+static void requireSameHand(const Hand& expected, const Hand& actual) {
+  BOOST_REQUIRE(expected.getTableName() == actual.getTableName());
+  BOOST_REQUIRE(expected.getStartDate() == actual.getStartDate());
+  BOOST_REQUIRE(expected.getSeats() == actual.getSeats());
+  BOOST_REQUIRE(expected.getWinnerSeats() == actual.getWinnerSeats());
+  BOOST_REQUIRE(expected.getBoardCardSet() == actual.getBoardCardSet());
+  BOOST_REQUIRE(expected.viewActions().size() == actual.viewActions().size());
+
+  for (std::size_t i { 0 }; i < expected.viewActions().size(); ++i) {
+    const auto& e { expected.viewActions()[i] };
+    const auto& a { actual.viewActions()[i] };
+    BOOST_REQUIRE(e.getPlayerId() == a.getPlayerId() and e.getStreet() == a.getStreet() and e.getType() == a.getType()
+                  and e.getIndex() == a.getIndex() and e.getBetAmount() == a.getBetAmount());
+  }
+}
+
+[[nodiscard]] static std::vector<HandId> getHandIds(const Site& site) {
+  std::vector<HandId> ret;
+  std::ranges::for_each(site.viewCashGames(), [&ret](const CashGame * pGame) {
+    std::ranges::transform(pGame->viewHands(), std::back_inserter(ret), &Hand::getId);
+  });
+  return ret;
+}
+
+[[nodiscard]] static bool hasDuplicatedHands(const Site& site) {
+  auto ids { getHandIds(site) };
+  std::ranges::sort(ids);
+  return ids.end() != std::ranges::adjacent_find(ids);
+}
+
+BOOST_AUTO_TEST_SUITE(WinamaxHistoryTest)
+
+BOOST_AUTO_TEST_CASE(WinamaxHistoryTest_refreshFileShouldAddOnlyTheAppendedHand) {
+  const auto file { makeTestDir("refreshFile") / HISTORY_FILE.filename() };
+  std::filesystem::copy_file(HISTORY_FILE, file);
+  WinamaxHistory wh;
+  const auto pSite { wh.reloadFile(file) };
+  BOOST_REQUIRE(nullptr != pSite);
+  BOOST_REQUIRE(NB_HANDS == getHandIds(*pSite).size());
+  BOOST_REQUIRE(0 == wh.refreshFile(file, *pSite));
+  writeFile(file, newHand(), std::ios::app);
+  BOOST_REQUIRE(1 == wh.refreshFile(file, *pSite));
+  BOOST_REQUIRE(0 == wh.refreshFile(file, *pSite));
+  BOOST_REQUIRE(NB_HANDS + 1 == getHandIds(*pSite).size());
+  BOOST_REQUIRE(1 == pSite->viewCashGames().size());
+  BOOST_REQUIRE(!hasDuplicatedHands(*pSite));
+}
+
+BOOST_AUTO_TEST_CASE(WinamaxHistoryTest_refreshFileShouldNotCountTheKnownHands) {
+  const auto file { makeTestDir("refreshFileKnownHands") / HISTORY_FILE.filename() };
+  std::filesystem::copy_file(HISTORY_FILE, file);
+  WinamaxHistory wh;
+  const auto pSite { wh.reloadFile(file) };
+  BOOST_REQUIRE(nullptr != pSite);
+  auto firstHand { readFile(HISTORY_FILE) };
+  firstHand.resize(firstHand.find("\n\n\n") + 3);
+  writeFile(file, firstHand + newHand(), std::ios::app); // a hand already read, then a new one
+  BOOST_REQUIRE(1 == wh.refreshFile(file, *pSite));
+  BOOST_REQUIRE(NB_HANDS + 1 == getHandIds(*pSite).size());
+  BOOST_REQUIRE(!hasDuplicatedHands(*pSite));
+}
+
+BOOST_AUTO_TEST_CASE(WinamaxHistoryTest_refreshFileShouldWaitForTheEndOfAHand) {
+  const auto file { makeTestDir("refreshFileIncompleteHand") / HISTORY_FILE.filename() };
+  std::filesystem::copy_file(HISTORY_FILE, file);
+  WinamaxHistory wh;
+  const auto pSite { wh.reloadFile(file) };
+  BOOST_REQUIRE(nullptr != pSite);
+  const auto hand { newHand() };
+  writeFile(file, hand.substr(0, hand.size() - 3), std::ios::app); // not yet followed by its empty lines
+  BOOST_REQUIRE(0 == wh.refreshFile(file, *pSite));
+  writeFile(file, "\n\n\n", std::ios::app);
+  BOOST_REQUIRE(1 == wh.refreshFile(file, *pSite));
+  BOOST_REQUIRE(NB_HANDS + 1 == getHandIds(*pSite).size());
+}
+
+BOOST_AUTO_TEST_CASE(WinamaxHistoryTest_reloadFileShouldWaitForTheEmptyLinesOfTheLastHand) {
+  const auto file { makeTestDir("reloadFile") / HISTORY_FILE.filename() };
+  auto content { readFile(HISTORY_FILE) };
+  content.resize(content.find_last_not_of('\n') + 1);
+  writeFile(file, content);
+  WinamaxHistory wh;
+  const auto pSite { wh.reloadFile(file) };
+  BOOST_REQUIRE(nullptr != pSite);
+  BOOST_REQUIRE(NB_HANDS - 1 == getHandIds(*pSite).size());
+  writeFile(file, "\n\n\n", std::ios::app);
+  BOOST_REQUIRE(1 == wh.refreshFile(file, *pSite));
+  BOOST_REQUIRE(NB_HANDS == getHandIds(*pSite).size());
+}
+
+BOOST_AUTO_TEST_CASE(WinamaxHistoryTest_refreshFileShouldReadAHandWrittenInTwoHalves) {
+  const auto dir { makeTestDir("refreshFileTwoHalves") };
+  const auto hand { newHand() };
+  const auto expectedFile { dir / "expected" / HISTORY_FILE.filename() };
+  std::filesystem::create_directories(expectedFile.parent_path());
+  writeFile(expectedFile, readFile(HISTORY_FILE) + hand);
+  const auto file { dir / HISTORY_FILE.filename() };
+  // the file is reloaded while Winamax is writing the middle of a line of the new hand
+  writeFile(file, readFile(HISTORY_FILE) + hand.substr(0, hand.size() / 2));
+  WinamaxHistory wh;
+  const auto pSite { wh.reloadFile(file) };
+  BOOST_REQUIRE(nullptr != pSite);
+  BOOST_REQUIRE(NB_HANDS == getHandIds(*pSite).size());
+  writeFile(file, hand.substr(hand.size() / 2), std::ios::app);
+  BOOST_REQUIRE(1 == wh.refreshFile(file, *pSite));
+  const auto pExpected { wh.reloadFile(expectedFile) };
+  const auto expectedIds { getHandIds(*pExpected) };
+  BOOST_REQUIRE(expectedIds == getHandIds(*pSite));
+  requireSameHand(*findHand(*pExpected, expectedIds.back()), *findHand(*pSite, expectedIds.back()));
+}
+
+BOOST_AUTO_TEST_CASE(WinamaxHistoryTest_aMalformedHandShouldNotSkipTheNextOne) {
+  WinamaxHistory wh;
+  const auto pExpected { wh.reloadFile(HISTORY_FILE) };
+  const auto original { readFile(HISTORY_FILE) };
+  const auto handStarts { getHandStarts(original) };
+  BOOST_REQUIRE(NB_HANDS == handStarts.size());
+  const auto badHandStart { handStarts[45] }; // in the middle of the file
+  const auto badHandEnd { handStarts[46] };
+  const auto nextHandIdStart { original.find('#', badHandEnd) + 1 };
+  const auto nextHandId { HandId::parse(std::string_view(original).substr(nextHandIdStart,
+                                        original.find(' ', nextHandIdStart) - nextHandIdStart)) };
+  BOOST_REQUIRE(nextHandId.has_value());
+  const auto flopEnd { original.find('\n', original.find("*** FLOP ***", badHandStart)) + 1 };
+  const auto seatStart { original.find("Seat 3: ", badHandStart) };
+  BOOST_REQUIRE(flopEnd < badHandEnd and seatStart < badHandEnd);
+  auto truncated { original };
+  truncated.erase(flopEnd, badHandEnd - flopEnd); // the next hand starts right after the flop
+  auto corrupted { original };
+  corrupted.replace(seatStart, 7, "Seat 13:"); // not a seat number
+
+  for (const auto& [name, content] : { std::pair { "truncatedHand", truncated }, std::pair { "corruptedHand", corrupted } }) {
+    const auto file { makeTestDir(name) / HISTORY_FILE.filename() };
+    writeFile(file, content);
+    const auto pSite { wh.reloadFile(file) };
+    BOOST_REQUIRE(nullptr != pSite);
+    BOOST_REQUIRE_MESSAGE(NB_HANDS - 1 == getHandIds(*pSite).size(), name << " gives " << getHandIds(*pSite).size() << " hands");
+    const auto pNextHand { findHand(*pSite, nextHandId.value()) };
+    BOOST_REQUIRE(nullptr != pNextHand);
+    requireSameHand(*findHand(*pExpected, nextHandId.value()), *pNextHand);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(WinamaxHistoryTest_aWinnerWithoutSeatShouldSkipItsHand) {
+  const auto file { makeTestDir("winnerWithoutSeat") / HISTORY_FILE.filename() };
+  auto content { readFile(HISTORY_FILE) };
+  content.replace(content.find("SR.Varianza collected"), 11, "NotSeatedPlayer");
+  writeFile(file, content);
+  WinamaxHistory wh;
+  const auto pSite { wh.reloadFile(file) };
+  BOOST_REQUIRE(nullptr != pSite);
+  BOOST_REQUIRE(NB_HANDS - 1 == getHandIds(*pSite).size());
+}
+
+BOOST_AUTO_TEST_CASE(WinamaxHistoryTest_loadShouldKeepTheHandsAfterAFirstChunkWithoutValidHand) {
+  const auto dir { makeHistoryDir("firstChunkWithoutValidHand") };
+  // a file parsed in 2 chunks, the hands of its first 16 copies of the history file, more than its
+  // first half, having an invalid table line
+  constexpr std::size_t nbCopies { 30 };
+  constexpr std::size_t nbInvalidCopies { 16 };
+  std::string content;
+
+  for (std::size_t i { 0 }; i < nbCopies; ++i) {
+    auto copy { withTableId(std::to_string(10000000 + i)) };
+
+    for (auto pos { copy.find("\nTable: ") }; i < nbInvalidCopies and std::string::npos != pos; pos = copy.find("\nTable: ", pos)) {
+      copy.replace(pos + 1, 6, "Tablx:");
+    }
+
+    content += copy;
+  }
+
+  BOOST_REQUIRE(2 * 1024 * 1024 < content.size());
+  writeFile(dir / "history" / HISTORY_FILE.filename(), content);
+  WinamaxHistory wh;
+  wh.setCacheDir({}); // not the cache of the user
+  wh.setNbImportThreads(2);
+  const auto pSite { wh.load(dir, {}, {}) };
+  BOOST_REQUIRE(1 == pSite->viewCashGames().size());
+  BOOST_REQUIRE((nbCopies - nbInvalidCopies) * NB_HANDS == getHandIds(*pSite).size());
+}
+
+BOOST_AUTO_TEST_CASE(WinamaxHistoryTest_loadFileShouldReadTheCache) {
+  const auto cacheDir { makeTestDir("loadFileCache") / "cache" };
+  WinamaxHistory wh;
+  wh.setCacheDir(cacheDir);
+  const auto pParsed { wh.loadFile(HISTORY_FILE) };
+  BOOST_REQUIRE(nullptr != pParsed);
+  BOOST_REQUIRE(1 == std::distance(std::filesystem::directory_iterator(cacheDir), std::filesystem::directory_iterator()));
+  const auto pCached { wh.loadFile(HISTORY_FILE) };
+  BOOST_REQUIRE(nullptr != pCached);
+  BOOST_REQUIRE(getHandIds(*pParsed) == getHandIds(*pCached));
+}
+
+BOOST_AUTO_TEST_CASE(WinamaxHistoryTest_loadShouldWriteTheHandStore) {
+  const auto dir { makeHistoryDir("loadHandStore") };
+  std::filesystem::copy_file(HISTORY_FILE, dir / "history" / HISTORY_FILE.filename());
+  WinamaxHistory wh;
+  wh.setCacheDir(dir / "cache");
+  const auto pSite { wh.load(dir, {}, {}) };
+  const HandStore store { wh.getHandStoreFile() };
+  BOOST_REQUIRE(NB_HANDS == store.getNbHands());
+  BOOST_REQUIRE(std::ranges::equal(getHandIds(*pSite), store.getHandIds()));
+  wh.setCacheDir({});
+  BOOST_REQUIRE(wh.getHandStoreFile().empty());
+}
+
+BOOST_AUTO_TEST_CASE(WinamaxHistoryTest_loadShouldSortTheGamesByFile) {
+  const auto dir { makeHistoryDir("loadOrder") };
+  const std::array tableIds { "11111111", "22222222", "33333333", "44444444" };
+
+  for (std::size_t i { 0 }; i < tableIds.size(); ++i) {
+    writeFile(dir / "history" / std::format("2019020{}_Colorado_real_holdem_no-limit.txt", tableIds.size() - i),
+              withTableId(tableIds[i]));
+  }
+
+  WinamaxHistory wh;
+  wh.setCacheDir({}); // not the cache of the user
+  wh.setNbImportThreads(tableIds.size());
+  const auto pSite { wh.load(dir, {}, {}) };
+  BOOST_REQUIRE(tableIds.size() == pSite->viewCashGames().size());
+  std::vector<std::string_view> gameIds;
+  std::ranges::transform(pSite->viewCashGames(), std::back_inserter(gameIds), &Game::getId);
+  BOOST_REQUIRE(std::ranges::is_sorted(gameIds));
+  BOOST_REQUIRE(NB_HANDS * tableIds.size() == getHandIds(*pSite).size());
+}
+
+BOOST_AUTO_TEST_CASE(WinamaxHistoryTest_loadShouldGiveTheSameSiteWhateverTheMergeOrder) {
+  const auto dir { makeHistoryDir("loadMergeOrder") };
+  const auto content { readFile(HISTORY_FILE) };
+  const auto handStarts { getHandStarts(content) };
+
+  // files of different sizes, so that the biggest ones, parsed first, are not the first ones
+  for (std::size_t i { 0 }; i < 8; ++i) {
+    const auto tableId { std::to_string(11111111 * (i + 1)) };
+    const auto file { dir / "history" / std::format("2019020{}_Colorado{}_real_holdem_no-limit.txt", i + 1, i) };
+    writeFile(file, withTableId(tableId).substr(0, handStarts[(i * 37 + 10) % NB_HANDS]));
+  }
+
+  WinamaxHistory wh;
+  wh.setCacheDir({}); // not the cache of the user
+  std::optional<std::pair<std::vector<std::string>, std::vector<HandId>>> oExpected;
+
+  for (const auto nbThreads : { 1UZ, 2UZ, 3UZ, 8UZ, 1UZ, 3UZ }) {
+    wh.setNbImportThreads(nbThreads);
+    const auto pSite { wh.load(dir, {}, {}) };
+    std::vector<std::string> gameIds;
+    std::ranges::transform(pSite->viewCashGames(), std::back_inserter(gameIds), [](const CashGame * pGame) {
+      return std::string(pGame->getId());
+    });
+    const auto actual { std::pair { gameIds, getHandIds(*pSite) } };
+
+    if (!oExpected.has_value()) {
+      BOOST_REQUIRE(8 == gameIds.size());
+      BOOST_REQUIRE(std::ranges::is_sorted(gameIds));
+      oExpected = actual;
+    }
+
+    BOOST_REQUIRE(oExpected.value() == actual);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(WinamaxHistoryTest_loadShouldDropTheCopyOfAFile) {
+  const auto dir { makeHistoryDir("loadCopy") };
+  std::filesystem::copy_file(HISTORY_FILE, dir / "history" / HISTORY_FILE.filename());
+  std::filesystem::copy_file(HISTORY_FILE, dir / "history" / "20190206_Colorado_real_holdem_no-limit_backup.txt");
+  WinamaxHistory wh;
+  wh.setCacheDir({}); // not the cache of the user
+  wh.setNbImportThreads(2);
+
+  // the jobs end in any order, the hands are always kept from the first file
+  for (int i { 0 }; i < 5; ++i) {
+    const auto pSite { wh.load(dir, {}, {}) };
+    BOOST_REQUIRE(NB_HANDS == getHandIds(*pSite).size());
+    BOOST_REQUIRE(!hasDuplicatedHands(*pSite));
+    BOOST_REQUIRE(1 == pSite->viewCashGames().size());
+    BOOST_REQUIRE(HISTORY_FILE.stem() == pSite->viewCashGames().front()->getId());
+  }
+}
+
+BOOST_AUTO_TEST_CASE(WinamaxHistoryTest_loadShouldNotParseTheCopyOfAFile) {
+  const auto dir { makeHistoryDir("loadCopyNotParsed") };
+  std::filesystem::copy_file(HISTORY_FILE, dir / "history" / HISTORY_FILE.filename());
+  std::filesystem::copy_file(HISTORY_FILE, dir / "history" / "20190206_Colorado_real_holdem_no-limit_backup.txt");
+  WinamaxHistory wh;
+  wh.setCacheDir(dir / "cache");
+  wh.setNbImportThreads(2);
+  const auto pSite { wh.load(dir, {}, {}) };
+  BOOST_REQUIRE(NB_HANDS == getHandIds(*pSite).size());
+  // only the parsed file is cached
+  const auto nbCacheFiles { std::count_if(std::filesystem::directory_iterator(dir / "cache"), std::filesystem::directory_iterator(),
+  [](const auto & entry) { return ".prmc" == entry.path().extension(); }) };
+  BOOST_REQUIRE(1 == nbCacheFiles);
+}
+
+BOOST_AUTO_TEST_CASE(WinamaxHistoryTest_loadShouldKeepTheHandsOfSeveralFilesOnce) {
+  const auto dir { makeHistoryDir("loadSharedHands") };
+  const auto content { readFile(HISTORY_FILE) };
+  const auto handStarts { getHandStarts(content) };
+  BOOST_REQUIRE(NB_HANDS == handStarts.size());
+  // the hands 30 to 59 are in both files, the first file in the path order being the second one
+  writeFile(dir / "history" / "20190206_Colorado_real_holdem_no-limit.txt", content.substr(0, handStarts[60]));
+  writeFile(dir / "history" / "20190205_Colorado_real_holdem_no-limit.txt", content.substr(handStarts[30]) + newHand());
+  WinamaxHistory wh;
+  wh.setCacheDir({}); // not the cache of the user
+  wh.setNbImportThreads(2);
+
+  for (int i { 0 }; i < 5; ++i) {
+    const auto pSite { wh.load(dir, {}, {}) };
+    BOOST_REQUIRE(NB_HANDS + 1 == getHandIds(*pSite).size());
+    BOOST_REQUIRE(!hasDuplicatedHands(*pSite));
+    BOOST_REQUIRE(2 == pSite->viewCashGames().size());
+    BOOST_REQUIRE(NB_HANDS - 30 + 1 == pSite->viewCashGames()[0]->getNbHands());
+    BOOST_REQUIRE(30 == pSite->viewCashGames()[1]->getNbHands());
+  }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,56 @@
+module;
+
+#include <boost/test/unit_test.hpp>
+
+export module test.history.WinamaxLine;
+
+import history.WinamaxLine;
+
+import std;
+
+static const std::filesystem::path HISTORY_FILE { TEST_RESOURCES_DIR "20190206_Colorado_real_holdem_no-limit.txt" };
+
+// the fixture has no tournament hand
+static constexpr std::array OTHER_LINES {
+  "HusKKy posts ante 50", "Winamax Poker - Tournament \"Freeroll\" buyIn: 0.45€ + 0.05€ level: 1 - HandId: #1-2-3"
+};
+
+[[nodiscard]] static std::vector<std::string> readLines(const std::filesystem::path& file) {
+  std::ifstream in { file, std::ios::binary };
+  std::vector<std::string> ret;
+
+  for (std::string line; std::getline(in, line);) {
+    if (line.ends_with('\r')) { line.pop_back(); }
+
+    ret.push_back(std::move(line));
+  }
+
+  return ret;
+}
+
+[[nodiscard]] static auto toTuple(const WinamaxLine& line) {
+  return std::tuple { line.kind, line.street, line.actionType, line.playerName, line.seatNumber, line.amount, line.cards };
+}
+
+BOOST_AUTO_TEST_SUITE(WinamaxLineTest)
+
+BOOST_AUTO_TEST_CASE(WinamaxLineTest_classifyShouldAgreeWithTheScalarClassifier) {
+  auto lines { readLines(HISTORY_FILE) };
+  lines.insert(lines.end(), OTHER_LINES.begin(), OTHER_LINES.end());
+  std::set<WinamaxLineKind> kinds;
+
+  for (const auto& line : lines) {
+    kinds.insert(winamaxLine::classifyScalar(line).kind);
+
+    // the line moved by 0 to 16 bytes, so that its spaces fall at every position of a SIMD chunk
+    for (std::size_t shift { 0 }; shift <= 16; ++shift) {
+      const auto shifted { std::string(shift, 'x') + line };
+      BOOST_REQUIRE_MESSAGE(toTuple(winamaxLine::classifyScalar(shifted)) == toTuple(winamaxLine::classify(shifted)),
+                            "the classifiers differ for '" << shifted << "'");
+    }
+  }
+
+  BOOST_REQUIRE(static_cast<std::size_t>(WinamaxLineKind::board) + 1 == kinds.size()); // every kind of line
+}
+
+BOOST_AUTO_TEST_SUITE_END()
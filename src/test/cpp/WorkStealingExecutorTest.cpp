@@ -0,0 +1,54 @@
+module;
+
+#include <boost/test/unit_test.hpp>
+
+export module test.system.WorkStealingExecutor;
+
+import system.WorkStealingExecutor;
+
+import std;
+
+// jobs counting their runs in nbRuns, the job thrower throwing
+[[nodiscard]] static std::vector<std::function<void()>> makeJobs(std::vector<std::atomic_size_t>& nbRuns,
+    std::size_t thrower) {
+  std::vector<std::function<void()>> ret;
+
+  for (std::size_t i { 0 }; i < nbRuns.size(); ++i) {
+    ret.push_back([&nbRuns, i, thrower]() {
+      ++nbRuns[i];
+
+      if (thrower == i) { throw std::runtime_error("job failure"); }
+    });
+  }
+
+  return ret;
+}
+
+BOOST_AUTO_TEST_SUITE(WorkStealingExecutorTest)
+
+BOOST_AUTO_TEST_CASE(WorkStealingExecutorTest_shouldRunEveryJobOnce) {
+  for (const auto nbWorkers : { 1UZ, 2UZ, 8UZ, 100UZ }) {
+    std::vector<std::atomic_size_t> nbRuns(50);
+    WorkStealingExecutor executor { makeJobs(nbRuns, nbRuns.size()), nbWorkers };
+    executor.wait();
+    BOOST_REQUIRE(std::ranges::all_of(nbRuns, [](const auto & n) { return 1 == n.load(); }));
+  }
+}
+
+BOOST_AUTO_TEST_CASE(WorkStealingExecutorTest_waitShouldRethrowTheExceptionOfAJob) {
+  std::vector<std::atomic_size_t> nbRuns(50);
+  WorkStealingExecutor executor { makeJobs(nbRuns, 10), 4 };
+  BOOST_REQUIRE_THROW(executor.wait(), std::runtime_error);
+  // the other jobs are run anyway
+  BOOST_REQUIRE(std::ranges::all_of(nbRuns, [](const auto & n) { return 1 == n.load(); }));
+}
+
+BOOST_AUTO_TEST_CASE(WorkStealingExecutorTest_destructorShouldNotThrow) {
+  std::vector<std::atomic_size_t> nbRuns(50);
+  {
+    const WorkStealingExecutor executor { makeJobs(nbRuns, 0), 4 };
+  }
+  BOOST_REQUIRE(std::ranges::all_of(nbRuns, [](const auto & n) { return 1 == n.load(); }));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -27,4 +27,27 @@ BOOST_AUTO_TEST_CASE(stringsTest_splitNonEmptyWithEndingDelimiterShouldSucceed)
   BOOST_REQUIRE(tokens[1] == "b");
 }
 
+BOOST_AUTO_TEST_CASE(stringsTest_linePatternShouldCaptureTheFields) {
+  using TableLine = language::strings::LinePattern<"^Table: '(.*?)' (.*?)-max .* Seat #(.*) is the button$">;
+  const auto oCaptures { TableLine::match("Table: 'Expresso(111550795)#0' 3-max (real money) Seat #1 is the button") };
+  BOOST_REQUIRE(oCaptures.has_value());
+  BOOST_REQUIRE(oCaptures.value()[0] == "Expresso(111550795)#0");
+  BOOST_REQUIRE(oCaptures.value()[1] == "3");
+  BOOST_REQUIRE(oCaptures.value()[2] == "1");
+  BOOST_REQUIRE(!TableLine::match("Table: 'Colorado' 6-max (real money) Seat #6 is the button!").has_value());
+}
+
+BOOST_AUTO_TEST_CASE(stringsTest_linePatternShouldBacktrackLikeARegex) {
+  using GreedyLine = language::strings::LinePattern<"(.*) posts ante (.*)">;
+  using LazyLine = language::strings::LinePattern<"(.*?) posts ante (.*)">;
+  using BlindsLine = language::strings::LinePattern<".* \\((.*)/(.*)\\) - (.*) UTC">;
+  BOOST_REQUIRE(GreedyLine::match("a posts ante b posts ante 5").value()[0] == "a posts ante b");
+  BOOST_REQUIRE(LazyLine::match("a posts ante b posts ante 5").value()[0] == "a");
+  const auto oBlinds { BlindsLine::match("Holdem no limit (0.01€/0.02€) - 2019/02/06 08:22:31 UTC") };
+  BOOST_REQUIRE(oBlinds.has_value());
+  BOOST_REQUIRE(oBlinds.value()[0] == "0.01€");
+  BOOST_REQUIRE(oBlinds.value()[1] == "0.02€");
+  BOOST_REQUIRE(oBlinds.value()[2] == "2019/02/06 08:22:31");
+}
+
 BOOST_AUTO_TEST_SUITE_END()
\ No newline at end of file